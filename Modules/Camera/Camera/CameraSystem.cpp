@@ -38,29 +38,17 @@ void CameraSystem::onDeinitialize(ECS::Registry& registry)
 void CameraSystem::tick(float deltaTime, ECS::Registry& registry)
 {
     ECS::View<Transform, CameraComponent> view(registry);
-    for (const ECS::EntityId& entityId : view)
+    view.each([](ECS::EntityId entityId, const Transform& transform, CameraComponent& cameraComponent)
     {
-        Transform* transform = registry.get<Transform>(entityId);
-        if (transform == nullptr)
-        {
-            continue;
-        }
-
-        CameraComponent* cameraComponent = registry.get<CameraComponent>(entityId);
-        if (cameraComponent == nullptr)
-        {
-            continue;
-        }
-
-        cameraComponent->view = glm::lookAt(transform->position, transform->position + transform->forward(), transform->up());
+        cameraComponent.view = glm::lookAt(transform.position, transform.position + transform.forward(), transform.up());
         
-        const CameraConfig& config = cameraComponent->config;
+        const CameraConfig& config = cameraComponent.config;
         MANI_ASSERT(std::abs(config.height) > FLT_EPSILON, "Height of a camera cannot be 0.");
-        cameraComponent->projection = glm::perspective(glm::radians(config.fov), 
-                                                        config.width / config.height,
-                                                        config.nearClipPlane, 
-                                                        config.farClipPlane);
-    }
+        cameraComponent.projection = glm::perspective(glm::radians(config.fov), 
+                                                      config.width / config.height,
+                                                      config.nearClipPlane, 
+                                                      config.farClipPlane);
+    });
 }
 
 const CameraComponent* CameraSystem::getCameraComponent(const ECS::Registry& registry) const
@@ -75,7 +63,7 @@ Transform* CameraSystem::getCameraTransform(ECS::Registry& registry) const
 
 void CameraSystem::setCameraConfig(ECS::Registry& registry, const CameraConfig& config)
 {
-    if (auto* cameraComponent = registry.get<CameraComponent>(m_cameraId))
+    if (auto* cameraComponent = registry.getMut<CameraComponent>(m_cameraId))
     {
         cameraComponent->config = config;
     }
@@ -3,6 +3,7 @@
 #include <Camera/Camera.h>
 #include <Core/System/System.h>
 #include <ECS/Entity.h>
+#include <ECS/ComponentPool.h>
 #include <glm/glm.hpp>
 #include <memory>
 
@@ -25,6 +26,9 @@ namespace Mani
 
 	struct CameraComponent
 	{
+		// cameras are rare, keep them packed.
+		static constexpr ECS::EComponentStorage storage = ECS::EComponentStorage::SparseSet;
+
 		CameraConfig config;
 
 		glm::mat4 projection;
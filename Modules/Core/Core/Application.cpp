@@ -4,6 +4,8 @@
 #include <Core/CoreTime.h>
 #include <Core/ManiAssert.h>
 #include <Core/Log/LogSystem.h>
+#include <Core/Jobs/JobSystem.h>
+#include <ECS/ParallelFor.h>
 
 using namespace Mani;
 
@@ -15,7 +17,19 @@ Application::Application()
 	MANI_ASSERT(s_application == nullptr, "an Application instance already exists.");
 	s_application = this;
 
+	// the job system is up before any system can use it.
+	m_jobSystem = new JobSystem();
+	ECS::setParallelFor([this](size_t batchCount, const std::function<void(size_t)>& function)
+	{
+		m_jobSystem->parallelFor(batchCount, function);
+	});
+
+#ifdef MANI_WEBGL
+	m_framePacer.setTargetRate(60.0f);
+#endif
+
 	m_systemContainer = new SystemContainer();
+	m_systemContainer->setJobSystem(m_jobSystem);
 	m_systemContainer->initialize();
 	m_systemContainer->createSystem<LogSystem>()
 		.createSystem<WorldSystem>();
@@ -27,6 +41,9 @@ Application::~Application()
 	m_systemContainer->destroySystem<WorldSystem>()
 		.destroySystem<LogSystem>();
 	delete m_systemContainer;
+
+	ECS::setParallelFor(nullptr);
+	delete m_jobSystem;
 	s_application = nullptr;
 }
 
@@ -40,16 +57,27 @@ SystemContainer& Application::getSystemContainer()
 	return *m_systemContainer;
 }
 
+JobSystem& Application::getJobSystem()
+{
+	return *m_jobSystem;
+}
+
 void Application::run()
 {
 	Time::onApplicationStart();
 	m_systemContainer->initialize();
 	m_isRunning = true;
 
+	m_framePacer.reset();
 	while (m_isRunning)
 	{
 		Time::onNewFrame();
 		tick(Time::getDeltaTime());
+
+		if (!m_framePacer.waitForNextFrame())
+		{
+			onFrameOverrun.broadcast(m_framePacer.getLastFrameDuration(), m_framePacer.getTargetFrameDuration());
+		}
 	}
 	m_systemContainer->deinitialize();
 }
@@ -59,6 +87,16 @@ void Application::stop()
 	m_isRunning = false;
 }
 
+void Application::setTargetTickRate(float tickRate)
+{
+	m_framePacer.setTargetRate(tickRate);
+}
+
+float Application::getTargetTickRate() const
+{
+	return m_framePacer.getTargetRate();
+}
+
 void Application::tick(float deltaTime)
 {
 	m_systemContainer->tick(deltaTime);
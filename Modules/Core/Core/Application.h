@@ -1,10 +1,13 @@
 #pragma once
 
 #include <Core/Core.h>
+#include <Core/FramePacer.h>
+#include <Events/Event.h>
 
 namespace Mani
 {
 	class SystemContainer;
+	class JobSystem;
 
 	class Application
 	{
@@ -14,13 +17,26 @@ namespace Mani
 
 		static Application& get();
 
+		// ticks until stop is called. With a target tick rate, each frame waits for its deadline instead of spinning.
 		void run();
 		void stop();
 
+		// ticks per second run aims for, e.g. a headless server's simulation rate. 0 ticks as fast as possible.
+		// Web builds default to 60, they have to hand each frame back to the browser.
+		void setTargetTickRate(float tickRate);
+		float getTargetTickRate() const;
+
+		// broadcast by run when a frame took longer than the target tick rate allows. Durations are in milliseconds.
+		DECLARE_EVENT(FrameOverrunEvent, float /*frameDuration*/, float /*targetFrameDuration*/);
+		FrameOverrunEvent onFrameOverrun;
+
 		// Inherited via ITickable
 		void tick(float deltaTime);
 	
 		SystemContainer& getSystemContainer();
+
+		// the application's worker threads. Systems schedule their jobs here, View::parallelEach runs on it too.
+		JobSystem& getJobSystem();
 		bool isRunning() const { return m_isRunning; }
 
 	private:
@@ -29,5 +45,7 @@ namespace Mani
 		bool m_isRunning = false;
 		
 		SystemContainer* m_systemContainer = nullptr;
+		JobSystem* m_jobSystem = nullptr;
+		FramePacer m_framePacer;
 	};
 }
\ No newline at end of file
@@ -5,11 +5,6 @@
 
 using namespace Mani;
 
-bool Mani::Transform::hasParent() const
-{
-	return ECS::isValid(parentId);
-}
-
 glm::mat4 Transform::calculateModelMatrix() const
 {
 	return	glm::translate(glm::mat4(1.0f), position) *
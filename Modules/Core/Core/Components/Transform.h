@@ -17,10 +17,6 @@ namespace Mani
 		glm::quat localRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
 		glm::vec3 localScale = glm::vec3(1.0f, 1.0f, 1.0f);
 
-		ECS::EntityId parentId = ECS::INVALID_ID;
-
-		bool hasParent() const;
-
 		glm::mat4 calculateModelMatrix() const;
 
 		glm::vec3 forward() const;
@@ -4,6 +4,7 @@
 #include <Core/Application.h>
 #include <Core/Log.h>
 #include <Core/ManiAssert.h>
+#include <Core/Jobs/JobSystem.h>
 
 #include <Core/System/System.h>
 #include <Core/System/SystemContainer.h>
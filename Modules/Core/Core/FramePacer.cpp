@@ -0,0 +1,115 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+using namespace Mani;
+
+namespace
+{
+	// sleep measurements kept in the estimate, older ones fade out so the estimate follows the system's load.
+	const uint64_t MAX_SLEEP_SAMPLES = 1000;
+}
+
+FramePacer::FramePacer()
+{
+	reset();
+}
+
+void FramePacer::setTargetRate(float targetRate)
+{
+	m_targetRate = std::max(targetRate, 0.0f);
+	reset();
+}
+
+float FramePacer::getTargetRate() const
+{
+	return m_targetRate;
+}
+
+float FramePacer::getTargetFrameDuration() const
+{
+	return m_targetRate > 0.0f ? 1000.0f / m_targetRate : 0.0f;
+}
+
+void FramePacer::reset()
+{
+	m_frameStart = Clock::now();
+	m_deadline = m_frameStart;
+}
+
+bool FramePacer::waitForNextFrame()
+{
+	const Clock::time_point now = Clock::now();
+	m_lastFrameDuration = std::chrono::duration<float, std::milli>(now - m_frameStart).count();
+
+	if (m_targetRate <= 0.0f)
+	{
+#ifdef __EMSCRIPTEN__
+		// hands the frame back to the browser.
+		emscripten_sleep(0);
+#endif
+		m_frameStart = Clock::now();
+		return true;
+	}
+
+	// deadlines follow each other at the target rate, a frame waking up late does not shift the next ones.
+	m_deadline += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_targetRate));
+	if (now > m_deadline)
+	{
+		// an overrun frame is not caught up by shorter frames.
+		m_deadline = now;
+		m_frameStart = now;
+		return false;
+	}
+
+	waitUntil(m_deadline);
+	m_frameStart = Clock::now();
+	return true;
+}
+
+float FramePacer::getLastFrameDuration() const
+{
+	return m_lastFrameDuration;
+}
+
+void FramePacer::waitUntil(Clock::time_point deadline)
+{
+#ifdef __EMSCRIPTEN__
+	// spinning would block the browser.
+	const double remaining = std::chrono::duration<double, std::milli>(deadline - Clock::now()).count();
+	emscripten_sleep(static_cast<unsigned int>(std::max(remaining, 0.0)));
+#else
+	while (true)
+	{
+		const double remaining = std::chrono::duration<double, std::milli>(deadline - Clock::now()).count();
+		const double pessimisticSleep = m_sleepMean + std::sqrt(m_sleepVariance);
+		if (remaining <= pessimisticSleep)
+		{
+			break;
+		}
+
+		const Clock::time_point sleepStart = Clock::now();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		recordSleep(std::chrono::duration<double, std::milli>(Clock::now() - sleepStart).count());
+	}
+
+	while (Clock::now() < deadline)
+	{
+		std::this_thread::yield();
+	}
+#endif
+}
+
+void FramePacer::recordSleep(double sleepDuration)
+{
+	// Welford's online mean and variance.
+	m_sleepCount = std::min(m_sleepCount + 1, MAX_SLEEP_SAMPLES);
+	const double delta = sleepDuration - m_sleepMean;
+	m_sleepMean += delta / static_cast<double>(m_sleepCount);
+	m_sleepVariance += (delta * (sleepDuration - m_sleepMean) - m_sleepVariance) / static_cast<double>(m_sleepCount);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Core/Core.h>
+#include <chrono>
+
+namespace Mani
+{
+	/*
+	 * Paces a loop at a target rate. Waiting sleeps while the OS scheduler can be trusted to wake the thread up in time,
+	 * then spins for the rest of the frame. The sleep overshoot is measured as the loop runs.
+	 * Durations are in milliseconds.
+	 */
+	class FramePacer
+	{
+	public:
+		FramePacer();
+
+		// frames per second. 0 does not pace the loop.
+		void setTargetRate(float targetRate);
+		float getTargetRate() const;
+
+		// returns the duration of a frame at the target rate, 0 if the loop is not paced.
+		float getTargetFrameDuration() const;
+
+		// restarts the pacing from now. Called before the first frame.
+		void reset();
+
+		// waits until the current frame's deadline, then starts the next frame.
+		// returns false if the frame overran its deadline: the next frame starts right away and the deadlines restart from now.
+		bool waitForNextFrame();
+
+		// time spent in the last frame before waitForNextFrame, waiting excluded.
+		float getLastFrameDuration() const;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		float m_targetRate = 0.0f;
+		Clock::time_point m_frameStart;
+		Clock::time_point m_deadline;
+		float m_lastFrameDuration = 0.0f;
+
+		// running mean and variance of a 1ms sleep's duration, in milliseconds.
+		double m_sleepMean = 1.0;
+		double m_sleepVariance = 0.0;
+		uint64_t m_sleepCount = 0;
+
+		// sleeps while the remaining time is longer than a pessimistic sleep, then spins.
+		void waitUntil(Clock::time_point deadline);
+		void recordSleep(double sleepDuration);
+	};
+}
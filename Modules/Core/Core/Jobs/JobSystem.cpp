@@ -0,0 +1,273 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+using namespace Mani;
+
+namespace
+{
+	// the job system and the deque of the current thread, set on worker threads only.
+	thread_local const JobSystem* t_jobSystem = nullptr;
+	thread_local size_t t_queueIndex = 0;
+}
+
+// JobCounter begin
+
+bool JobCounter::isDone() const
+{
+	// the completing thread releases the lock last, a waiter seeing 0 can safely destroy the counter.
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_pendingCount == 0;
+}
+
+// JobCounter end
+
+// JobSystem begin
+
+JobSystem::JobSystem(size_t workerCount)
+{
+	m_queues.reserve(workerCount + 1);
+	for (size_t i = 0; i < workerCount + 1; ++i)
+	{
+		m_queues.push_back(new WorkQueue());
+	}
+
+	m_workers.reserve(workerCount);
+	for (size_t i = 0; i < workerCount; ++i)
+	{
+		m_workers.emplace_back(&JobSystem::runWorker, this, i + 1);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_isStopping = true;
+	}
+	m_sleepCondition.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+	m_workers.clear();
+
+	// without workers, the jobs nobody waited on are still queued.
+	while (tryRunJob(0))
+	{
+	}
+
+	for (WorkQueue* queue : m_queues)
+	{
+		delete queue;
+	}
+	m_queues.clear();
+}
+
+size_t JobSystem::getDefaultWorkerCount()
+{
+#ifdef MANI_WEBGL
+	return 0;
+#else
+	const unsigned int coreCount = std::thread::hardware_concurrency();
+	return coreCount > 1 ? coreCount - 1 : 0;
+#endif
+}
+
+size_t JobSystem::getWorkerCount() const
+{
+	return m_workers.size();
+}
+
+void JobSystem::schedule(JobFunction job, JobCounter* counter)
+{
+	if (counter != nullptr)
+	{
+		std::lock_guard<std::mutex> lock(counter->m_mutex);
+		counter->m_pendingCount++;
+	}
+	push({ std::move(job), counter });
+}
+
+void JobSystem::scheduleAfter(JobCounter& dependency, JobFunction job, JobCounter* counter)
+{
+	if (counter != nullptr)
+	{
+		std::lock_guard<std::mutex> lock(counter->m_mutex);
+		counter->m_pendingCount++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(dependency.m_mutex);
+		if (dependency.m_pendingCount > 0)
+		{
+			dependency.m_continuations.emplace_back(std::move(job), counter);
+			return;
+		}
+	}
+	push({ std::move(job), counter });
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+	const size_t queueIndex = getCurrentQueueIndex();
+	while (!counter.isDone())
+	{
+		if (!tryRunJob(queueIndex))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::parallelFor(size_t batchCount, const std::function<void(size_t batchIndex)>& function)
+{
+	if (batchCount == 0)
+	{
+		return;
+	}
+
+	// a few jobs pull the batches, idle threads keep pulling while busy ones stay on their batch.
+	std::atomic<size_t> nextBatchIndex = 0;
+	auto work = [&nextBatchIndex, batchCount, &function]()
+	{
+		for (size_t batchIndex = nextBatchIndex++; batchIndex < batchCount; batchIndex = nextBatchIndex++)
+		{
+			function(batchIndex);
+		}
+	};
+
+	JobCounter counter;
+	const size_t jobCount = std::min(batchCount - 1, m_workers.size());
+	for (size_t i = 0; i < jobCount; ++i)
+	{
+		schedule(work, &counter);
+	}
+
+	work();
+	wait(counter);
+}
+
+void JobSystem::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& function)
+{
+	grainSize = std::max<size_t>(grainSize, 1);
+	const size_t batchCount = (count + grainSize - 1) / grainSize;
+	parallelFor(batchCount, [count, grainSize, &function](size_t batchIndex)
+	{
+		const size_t begin = batchIndex * grainSize;
+		function(begin, std::min(begin + grainSize, count));
+	});
+}
+
+void JobSystem::runWorker(size_t queueIndex)
+{
+	t_jobSystem = this;
+	t_queueIndex = queueIndex;
+
+	while (true)
+	{
+		if (tryRunJob(queueIndex))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_sleepCondition.wait(lock, [this]() { return m_queuedJobCount > 0 || m_isStopping; });
+		if (m_isStopping && m_queuedJobCount == 0)
+		{
+			return;
+		}
+	}
+}
+
+void JobSystem::push(Job job)
+{
+	// counted first so a worker never sleeps while a job is queued.
+	m_queuedJobCount++;
+
+	WorkQueue* queue = m_queues[getCurrentQueueIndex()];
+	{
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		queue->jobs.push_back(std::move(job));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+	}
+	m_sleepCondition.notify_one();
+}
+
+bool JobSystem::tryRunJob(size_t queueIndex)
+{
+	Job job;
+	if (!tryPopJob(queueIndex, job))
+	{
+		return false;
+	}
+
+	job.function();
+	completeJob(job.counter);
+	return true;
+}
+
+bool JobSystem::tryPopJob(size_t queueIndex, Job& outJob)
+{
+	// the newest job of the thread's own deque is still hot in cache.
+	{
+		WorkQueue* queue = m_queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		if (!queue->jobs.empty())
+		{
+			outJob = std::move(queue->jobs.back());
+			queue->jobs.pop_back();
+			m_queuedJobCount--;
+			return true;
+		}
+	}
+
+	// steal the oldest job of another deque, it is the most likely to spawn more work.
+	for (size_t i = 1; i < m_queues.size(); ++i)
+	{
+		WorkQueue* queue = m_queues[(queueIndex + i) % m_queues.size()];
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		if (!queue->jobs.empty())
+		{
+			outJob = std::move(queue->jobs.front());
+			queue->jobs.pop_front();
+			m_queuedJobCount--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::completeJob(JobCounter* counter)
+{
+	if (counter == nullptr)
+	{
+		return;
+	}
+
+	std::vector<std::pair<JobFunction, JobCounter*>> continuations;
+	{
+		std::lock_guard<std::mutex> lock(counter->m_mutex);
+		counter->m_pendingCount--;
+		if (counter->m_pendingCount == 0)
+		{
+			continuations.swap(counter->m_continuations);
+		}
+	}
+
+	// the counter may be gone from here on, its continuations were moved out.
+	for (std::pair<JobFunction, JobCounter*>& continuation : continuations)
+	{
+		push({ std::move(continuation.first), continuation.second });
+	}
+}
+
+size_t JobSystem::getCurrentQueueIndex() const
+{
+	return t_jobSystem == this ? t_queueIndex : 0;
+}
+
+// JobSystem end
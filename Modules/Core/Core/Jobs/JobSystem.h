@@ -0,0 +1,110 @@
+#pragma once
+
+#include <Core/Core.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Mani
+{
+	class JobSystem;
+
+	/*
+	 * Counts the jobs that still have to run. A job scheduled with a counter increments it, and decrements it once it ran.
+	 * JobSystem::wait returns once the counter is done, the jobs scheduled after it with JobSystem::scheduleAfter are queued then.
+	 * A counter must outlive the jobs and the continuations using it.
+	 */
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		// returns true once every job counted here ran.
+		bool isDone() const;
+
+	private:
+		friend class JobSystem;
+
+		mutable std::mutex m_mutex;
+		size_t m_pendingCount = 0;
+		// jobs and their own counters, queued once the counter is done.
+		std::vector<std::pair<std::function<void()>, JobCounter*>> m_continuations;
+	};
+
+	/*
+	 * Work stealing job scheduler. Each worker thread owns a deque: it pops its newest job first and, once its deque is
+	 * empty, steals the oldest job of another deque. Threads that are not workers share one more deque.
+	 * Threads waiting on a counter run queued jobs instead of blocking, so jobs can wait on other jobs.
+	 */
+	class JobSystem
+	{
+	public:
+		using JobFunction = std::function<void()>;
+
+		// starts workerCount worker threads. With no worker, the jobs run on the threads calling wait or parallelFor.
+		explicit JobSystem(size_t workerCount = getDefaultWorkerCount());
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		// runs the jobs still queued, then joins the workers.
+		~JobSystem();
+
+		// one worker per core, the calling thread takes the last core.
+		static size_t getDefaultWorkerCount();
+
+		size_t getWorkerCount() const;
+
+		// queues a job. counter, if any, is incremented now and decremented once the job ran.
+		void schedule(JobFunction job, JobCounter* counter = nullptr);
+
+		// queues a job once dependency is done. counter, if any, is incremented now and decremented once the job ran.
+		void scheduleAfter(JobCounter& dependency, JobFunction job, JobCounter* counter = nullptr);
+
+		// runs queued jobs until counter is done. It can be called from a job.
+		void wait(JobCounter& counter);
+
+		// calls function(batchIndex) for each batch in [0, batchCount) and returns once every batch ran.
+		// the calling thread runs batches too. The signature matches ECS::ParallelForFunction.
+		void parallelFor(size_t batchCount, const std::function<void(size_t batchIndex)>& function);
+
+		// splits [0, count) in ranges of grainSize and calls function(begin, end) for each range.
+		void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& function);
+
+	private:
+		struct Job
+		{
+			JobFunction function;
+			JobCounter* counter = nullptr;
+		};
+
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		// the deque of the threads that are not workers comes first, then one deque per worker.
+		std::vector<WorkQueue*> m_queues;
+		std::vector<std::thread> m_workers;
+
+		// incremented before a job is queued, idle workers sleep while it is 0.
+		std::atomic<size_t> m_queuedJobCount = 0;
+		std::mutex m_sleepMutex;
+		std::condition_variable m_sleepCondition;
+		bool m_isStopping = false;
+
+		void runWorker(size_t queueIndex);
+		void push(Job job);
+		bool tryRunJob(size_t queueIndex);
+		bool tryPopJob(size_t queueIndex, Job& outJob);
+		void completeJob(JobCounter* counter);
+		size_t getCurrentQueueIndex() const;
+	};
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <Core/Core.h>
+#include <algorithm>
+#include <cstdint>
+
+namespace Mani
+{
+	/*
+	 * Accumulates variable frame durations and turns them into a whole amount of fixed steps.
+	 * The time left in the accumulator is the interpolation alpha between the last two steps.
+	 * Durations are in seconds, as Time::getDeltaTime.
+	 */
+	class FixedTimestep
+	{
+	public:
+		void setStepDuration(float stepDuration);
+		float getStepDuration() const;
+
+		// a frame runs at most maxStepCount steps. The time past them is dropped, so a slow frame does not make the next ones slower.
+		void setMaxStepCount(uint32_t maxStepCount);
+		uint32_t getMaxStepCount() const;
+
+		// adds deltaTime to the accumulator, then consumes and returns the amount of steps to run.
+		uint32_t advance(float deltaTime);
+
+		// the fraction of a step left in the accumulator, in [0, 1). Presentation systems blend the last two steps with it.
+		float getInterpolationAlpha() const;
+
+		// amount of steps dropped because a frame needed more than the max step count.
+		uint64_t getDroppedStepCount() const;
+
+		// empties the accumulator.
+		void reset();
+
+	private:
+		float m_stepDuration = 1.0f / 60.0f;
+		uint32_t m_maxStepCount = 5;
+		// doubles do not drift over long sessions.
+		double m_accumulator = 0.0;
+		uint64_t m_droppedStepCount = 0;
+	};
+
+	inline void FixedTimestep::setStepDuration(float stepDuration)
+	{
+		m_stepDuration = stepDuration;
+	}
+
+	inline float FixedTimestep::getStepDuration() const
+	{
+		return m_stepDuration;
+	}
+
+	inline void FixedTimestep::setMaxStepCount(uint32_t maxStepCount)
+	{
+		m_maxStepCount = maxStepCount;
+	}
+
+	inline uint32_t FixedTimestep::getMaxStepCount() const
+	{
+		return m_maxStepCount;
+	}
+
+	inline uint32_t FixedTimestep::advance(float deltaTime)
+	{
+		if (m_stepDuration <= 0.0f)
+		{
+			return 0;
+		}
+
+		m_accumulator += std::max(deltaTime, 0.0f);
+		const uint64_t dueStepCount = static_cast<uint64_t>(m_accumulator / m_stepDuration);
+		const uint64_t stepCount = std::min<uint64_t>(dueStepCount, m_maxStepCount);
+		m_droppedStepCount += dueStepCount - stepCount;
+
+		// dropped steps leave the accumulator too, only the fraction of a step remains.
+		m_accumulator = std::max(m_accumulator - static_cast<double>(dueStepCount) * m_stepDuration, 0.0);
+		return static_cast<uint32_t>(stepCount);
+	}
+
+	inline float FixedTimestep::getInterpolationAlpha() const
+	{
+		return m_stepDuration > 0.0f ? static_cast<float>(m_accumulator / m_stepDuration) : 0.0f;
+	}
+
+	inline uint64_t FixedTimestep::getDroppedStepCount() const
+	{
+		return m_droppedStepCount;
+	}
+
+	inline void FixedTimestep::reset()
+	{
+		m_accumulator = 0.0;
+	}
+}
@@ -19,6 +19,11 @@ ETickGroup SystemBase::getTickGroup() const
     return ETickGroup::Tick;
 }
 
+bool SystemBase::declareAccess(SystemAccess& access) const
+{
+    return false;
+}
+
 void SystemBase::initialize(ECS::Registry& registry, SystemContainer& systemContainer)
 {
     if (m_isInitialized)
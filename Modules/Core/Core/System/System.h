@@ -8,8 +8,10 @@ namespace Mani
 	enum class ETickGroup : uint8_t
 	{
 		PreTick = 0,
-		Tick = 1,
-		PostTick = 2,
+		// ticks at a fixed rate, see SystemContainer::getFixedTimestep. It may tick several times per frame, or none.
+		FixedTick = 1,
+		Tick = 2,
+		PostTick = 3,
 	};
 
 	namespace ECS
@@ -18,6 +20,7 @@ namespace Mani
 	}
 
 	class SystemContainer;
+	class SystemAccess;
 	
 	class SystemBase
 	{
@@ -26,6 +29,12 @@ namespace Mani
 		virtual bool shouldTick(ECS::Registry& registry) const;
 		virtual ETickGroup getTickGroup() const;
 
+		// declares the components tick reads and writes, then returns true. A system declaring its access may tick on a
+		// worker thread, at the same time as the systems of its tick group it does not conflict with. It must only touch
+		// the declared components and record structural changes in the container's command buffer.
+		// returns false by default: the system ticks alone, on the thread ticking the container.
+		virtual bool declareAccess(SystemAccess& access) const;
+
 		void initialize(ECS::Registry& registry, SystemContainer& systemContainer);
 		void deinitialize(ECS::Registry& registry);
 		
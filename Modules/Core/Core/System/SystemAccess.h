@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Core/Core.h>
+#include <ECS/Bitset.h>
+#include <ECS/Registry.h>
+
+namespace Mani
+{
+	/*
+	 * The components a system reads and writes while it ticks. Two systems conflict when one of them writes a component
+	 * the other one reads or writes. Component ids come from the registry the systems tick on.
+	 */
+	class SystemAccess
+	{
+	public:
+		SystemAccess(const ECS::Registry& inRegistry);
+
+		template<typename ...TComponents>
+		SystemAccess& read();
+
+		template<typename ...TComponents>
+		SystemAccess& write();
+
+		// returns true if the systems can not tick at the same time.
+		bool conflictsWith(const SystemAccess& other) const;
+
+	private:
+		const ECS::Registry* m_registry = nullptr;
+		Bitset<ECS::MAX_COMPONENTS> m_reads;
+		Bitset<ECS::MAX_COMPONENTS> m_writes;
+	};
+
+	inline SystemAccess::SystemAccess(const ECS::Registry& inRegistry)
+		: m_registry(&inRegistry)
+	{
+	}
+
+	template<typename ...TComponents>
+	inline SystemAccess& SystemAccess::read()
+	{
+		(m_reads.set(m_registry->getComponentId<TComponents>()), ...);
+		return *this;
+	}
+
+	template<typename ...TComponents>
+	inline SystemAccess& SystemAccess::write()
+	{
+		(m_writes.set(m_registry->getComponentId<TComponents>()), ...);
+		return *this;
+	}
+
+	inline bool SystemAccess::conflictsWith(const SystemAccess& other) const
+	{
+		return m_writes.intersects(other.m_reads) || m_writes.intersects(other.m_writes) || other.m_writes.intersects(m_reads);
+	}
+}
@@ -1,9 +1,15 @@
 #pragma once
 
 #include "System.h"
+#include "SystemAccess.h"
+#include "FixedTimestep.h"
+#include <Core/Jobs/JobSystem.h>
 #include <Core/ManiAssert.h>
 #include <ECS/Registry.h>
+#include <ECS/CommandBuffer.h>
 #include <Utils/TemplateUtils.h>
+#include <atomic>
+#include <functional>
 #include <vector>
 #include <memory>
 
@@ -11,6 +17,8 @@ namespace Mani
 {
 	// System container class. It manages unique systems. It also owns an EntityRegistry and is in charge
 	// of distributing the registry to systems.
+	// Within a tick group, systems declaring their component access tick concurrently on the job system when they
+	// do not conflict. Conflicting systems tick in creation order, systems not declaring their access tick alone.
 	class SystemContainer
 	{
 	public:
@@ -22,6 +30,12 @@ namespace Mani
 
 		void tick(float deltaTime);
 
+		// ticks the systems of the tick groups in [firstTickGroup, lastTickGroup] only.
+		void tick(float deltaTime, ETickGroup firstTickGroup, ETickGroup lastTickGroup);
+
+		// FixedTick systems tick a whole amount of fixed steps per frame, their deltaTime is the step duration.
+		FixedTimestep& getFixedTimestep();
+
 		// creates a new TSystem : public SystemBase
 		// if the container is initialized, the system will be initialized as well
 		// if a system of type TSystem already exists, a new system will not be created.
@@ -48,10 +62,41 @@ namespace Mani
 		// returns the amount of systems
 		size_t size() const;
 
+		// structural changes recorded here are applied to the registry after each tick group.
+		ECS::CommandBuffer& getCommandBuffer();
+
+		// systems declaring their access tick on jobSystem. Without a job system, every system ticks on the calling thread.
+		void setJobSystem(JobSystem* jobSystem);
+		JobSystem* getJobSystem() const;
+
 	private:
+		// a system of m_systems and the systems waiting for it.
+		struct SystemNode
+		{
+			// the system did not declare its access.
+			bool isExclusive = true;
+			// amount of earlier systems it conflicts with.
+			size_t dependencyCount = 0;
+			// indices of the later systems conflicting with it.
+			std::vector<size_t> dependents;
+		};
+
 		ECS::Registry m_registry;
+		ECS::CommandBuffer m_commandBuffer;
 		std::vector<std::shared_ptr<SystemBase>> m_systems;
+		// one node per system, rebuilt when a system is created or destroyed.
+		std::vector<SystemNode> m_systemNodes;
+		JobSystem* m_jobSystem = nullptr;
+		FixedTimestep m_fixedTimestep;
 		bool m_isInitialized = false;
+		bool m_isScheduleDirty = true;
+
+		void buildSchedule();
+		// ticks the systems of tickGroup, then flushes the command buffer.
+		void tickSystemsInGroup(ETickGroup tickGroup, float deltaTime);
+		void tickSystem(size_t systemIndex, float deltaTime);
+		// ticks the systems in [begin, end), they all declared their access.
+		void tickConcurrentSystems(size_t begin, size_t end, float deltaTime);
 	};
 
 	template<Derived<SystemBase> TSystem>
@@ -84,6 +129,7 @@ namespace Mani
 		}
 
 		m_systems.insert(insertIt, system);
+		m_isScheduleDirty = true;
 		return *this;
 	}
 
@@ -127,6 +173,7 @@ namespace Mani
 
 				system.reset();
 				m_systems.erase(it);
+				m_isScheduleDirty = true;
 				return *this;
 			}
 		}
@@ -164,23 +211,180 @@ namespace Mani
 	}
 
 	inline void SystemContainer::tick(float deltaTime)
+	{
+		tick(deltaTime, ETickGroup::PreTick, ETickGroup::PostTick);
+	}
+
+	inline void SystemContainer::tick(float deltaTime, ETickGroup firstTickGroup, ETickGroup lastTickGroup)
 	{
 		if (!m_isInitialized)
 		{
 			return;
 		}
 
-		for (auto& system : m_systems)
+		for (uint8_t group = static_cast<uint8_t>(firstTickGroup); group <= static_cast<uint8_t>(lastTickGroup); ++group)
 		{
-			if (system->shouldTick(m_registry) && system->isEnabled())
+			const ETickGroup tickGroup = static_cast<ETickGroup>(group);
+			if (tickGroup != ETickGroup::FixedTick)
 			{
-				system->tick(deltaTime, m_registry);
+				tickSystemsInGroup(tickGroup, deltaTime);
+				continue;
+			}
+
+			// fixed steps run at the same rate whatever the frame rate, they all tick with the step duration.
+			const uint32_t stepCount = m_fixedTimestep.advance(deltaTime);
+			for (uint32_t step = 0; step < stepCount; ++step)
+			{
+				tickSystemsInGroup(tickGroup, m_fixedTimestep.getStepDuration());
 			}
 		}
 	}
 
+	inline void SystemContainer::tickSystemsInGroup(ETickGroup tickGroup, float deltaTime)
+	{
+		// systems are sorted by tick group.
+		size_t i = 0;
+		while (i < m_systems.size() && m_systems[i]->getTickGroup() < tickGroup)
+		{
+			i++;
+		}
+
+		const size_t begin = i;
+		while (i < m_systems.size() && m_systems[i]->getTickGroup() == tickGroup)
+		{
+			if (m_isScheduleDirty)
+			{
+				buildSchedule();
+			}
+
+			// a run of systems declaring their access, up to the next exclusive system or the end of the tick group.
+			size_t end = i + 1;
+			if (m_jobSystem != nullptr && !m_systemNodes[i].isExclusive)
+			{
+				while (end < m_systems.size() && !m_systemNodes[end].isExclusive && m_systems[end]->getTickGroup() == tickGroup)
+				{
+					end++;
+				}
+			}
+
+			if (end - i > 1)
+			{
+				tickConcurrentSystems(i, end, deltaTime);
+			}
+			else
+			{
+				tickSystem(i, deltaTime);
+			}
+			i = end;
+		}
+
+		if (i > begin)
+		{
+			m_commandBuffer.flush(m_registry);
+		}
+	}
+
 	inline size_t SystemContainer::size() const
 	{
 		return m_systems.size();
 	}
+
+	inline ECS::CommandBuffer& SystemContainer::getCommandBuffer()
+	{
+		return m_commandBuffer;
+	}
+
+	inline FixedTimestep& SystemContainer::getFixedTimestep()
+	{
+		return m_fixedTimestep;
+	}
+
+	inline void SystemContainer::setJobSystem(JobSystem* jobSystem)
+	{
+		m_jobSystem = jobSystem;
+	}
+
+	inline JobSystem* SystemContainer::getJobSystem() const
+	{
+		return m_jobSystem;
+	}
+
+	inline void SystemContainer::buildSchedule()
+	{
+		std::vector<SystemAccess> accesses;
+		accesses.reserve(m_systems.size());
+		m_systemNodes.assign(m_systems.size(), SystemNode());
+		for (size_t i = 0; i < m_systems.size(); ++i)
+		{
+			SystemAccess access(m_registry);
+			m_systemNodes[i].isExclusive = !m_systems[i]->declareAccess(access);
+			accesses.push_back(access);
+		}
+
+		// exclusive systems split a tick group in runs, a system only waits for the conflicting systems of its run.
+		for (size_t i = 0; i < m_systems.size(); ++i)
+		{
+			if (m_systemNodes[i].isExclusive)
+			{
+				continue;
+			}
+
+			for (size_t j = i; j-- > 0;)
+			{
+				if (m_systemNodes[j].isExclusive || m_systems[j]->getTickGroup() != m_systems[i]->getTickGroup())
+				{
+					break;
+				}
+
+				if (accesses[j].conflictsWith(accesses[i]))
+				{
+					m_systemNodes[j].dependents.push_back(i);
+					m_systemNodes[i].dependencyCount++;
+				}
+			}
+		}
+
+		m_isScheduleDirty = false;
+	}
+
+	inline void SystemContainer::tickSystem(size_t systemIndex, float deltaTime)
+	{
+		SystemBase& system = *m_systems[systemIndex];
+		if (system.shouldTick(m_registry) && system.isEnabled())
+		{
+			system.tick(deltaTime, m_registry);
+		}
+	}
+
+	inline void SystemContainer::tickConcurrentSystems(size_t begin, size_t end, float deltaTime)
+	{
+		// a system is scheduled once the last system it waits for ticked.
+		std::vector<std::atomic<size_t>> remainingDependencyCounts(end - begin);
+		for (size_t i = begin; i < end; ++i)
+		{
+			remainingDependencyCounts[i - begin] = m_systemNodes[i].dependencyCount;
+		}
+
+		JobCounter counter;
+		std::function<void(size_t)> tickNode = [&](size_t systemIndex)
+		{
+			tickSystem(systemIndex, deltaTime);
+			for (const size_t dependent : m_systemNodes[systemIndex].dependents)
+			{
+				if (remainingDependencyCounts[dependent - begin].fetch_sub(1) == 1)
+				{
+					m_jobSystem->schedule([&tickNode, dependent]() { tickNode(dependent); }, &counter);
+				}
+			}
+		};
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (m_systemNodes[i].dependencyCount == 0)
+			{
+				m_jobSystem->schedule([&tickNode, i]() { tickNode(i); }, &counter);
+			}
+		}
+		m_jobSystem->wait(counter);
+	}
 }
\ No newline at end of file
@@ -1,5 +1,5 @@
 #include "TransformSystem.h"
-#include <Core/ManiAssert.h>
+#include <ECS/Hierarchy.h>
 
 using namespace Mani;
 
@@ -18,42 +18,42 @@ ETickGroup TransformSystem::getTickGroup() const
     return ETickGroup::PostTick;
 }
 
-void TransformSystem::tick(float deltaTime, ECS::Registry& registry)
+bool TransformSystem::declareAccess(SystemAccess& access) const
 {
-    m_processedTransforms.clear();
-    m_childrenMap.clear();
+    access.read<ECS::Relationship>()
+        .write<Transform>();
+    return true;
+}
 
-    ECS::View<Transform> transformView(registry);
-    for (const auto& entityId : transformView)
+void TransformSystem::tick(float deltaTime, ECS::Registry& registry)
+{
+    // roots keep their transform, each hierarchy is walked depth first so parents are updated before their children.
+    ECS::View<ECS::Relationship> relationshipView(registry);
+    relationshipView.each([&registry](ECS::EntityId entityId, ECS::Relationship& relationship)
     {
+        if (relationship.parent != ECS::INVALID_ID)
         {
-            Transform* transform = registry.get<Transform>(entityId);
-            if (!transform->hasParent())
-            {
-                // no parent, no worries.
-                m_processedTransforms.insert(entityId);
-                continue;
-            }
-
-            if (!m_processedTransforms.contains(transform->parentId))
-            {
-                // parent was not processed yet, keep it for later
-                m_childrenMap[transform->parentId].insert(entityId);
-                continue;
-            }
+            return;
         }
 
-        updateTransformsAndTheirChildrenRecursively(registry, entityId);
-    }
+        ECS::eachDescendant(registry, entityId, [&registry](ECS::EntityId descendantId)
+        {
+            updateTransform(registry, descendantId);
+        });
+    });
 }
 
 void TransformSystem::updateTransform(ECS::Registry& registry, ECS::EntityId entityId)
 {
-    Transform* transform = registry.get<Transform>(entityId);
-    MANI_ASSERT(transform != nullptr, "entity must have a transform component");
+    // entities of a hierarchy without a transform, or below a parent without one, are left alone.
+    const Transform* parentTransform = registry.get<Transform>(ECS::getParent(registry, entityId));
+    if (parentTransform == nullptr || !registry.has<Transform>(entityId))
+    {
+        return;
+    }
 
-    Transform* parentTransform = registry.get<Transform>(transform->parentId);
-    MANI_ASSERT(parentTransform != nullptr, "Parent entity must have a transform component");
+    // the world transform is rewritten, let Changed<Transform> views know.
+    Transform* transform = registry.getMut<Transform>(entityId);
 
     transform->position = transform->localPosition;
     transform->rotation = transform->localRotation;
@@ -71,26 +71,3 @@ void TransformSystem::updateTransform(ECS::Registry& registry, ECS::EntityId ent
     transform->scale.y = glm::length(glm::vec3(result[1]));
     transform->scale.z = glm::length(glm::vec3(result[2]));
 }
-
-void TransformSystem::updateTransformsAndTheirChildrenRecursively(ECS::Registry& registry, ECS::EntityId entityId)
-{
-    if (!ECS::isValid(entityId))
-    {
-        return;
-    }
-
-    MANI_ASSERT(!m_processedTransforms.contains(entityId), "Transform cycle detected!");
-
-    updateTransform(registry, entityId);
-    m_processedTransforms.insert(entityId);
-
-    if (m_childrenMap.contains(entityId))
-    {
-        for (const auto& childEntityId : m_childrenMap[entityId])
-        {
-            updateTransformsAndTheirChildrenRecursively(registry, childEntityId);
-        }
-    }
-
-    m_childrenMap.erase(entityId);
-}
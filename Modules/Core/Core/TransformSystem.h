@@ -1,8 +1,6 @@
 #pragma once
 
 #include <Core/CoreFwd.h>
-#include <set>
-#include <map>
 
 namespace Mani
 {
@@ -12,16 +10,11 @@ namespace Mani
 		virtual std::string_view getName() const override;
 		virtual bool shouldTick(ECS::Registry& registry) const override;
 		virtual ETickGroup getTickGroup() const override;
+		virtual bool declareAccess(SystemAccess& access) const override;
 
 		virtual void tick(float deltaTime, ECS::Registry& registry) override;
 
+		// computes an entity's world transform from its local transform and its parent's world transform.
 		static void updateTransform(ECS::Registry& registry, ECS::EntityId entityId);
-
-	private:
-		// keep set and map allocated since the same amount of transform will be processed each tick.
-		std::set<ECS::EntityId> m_processedTransforms;
-		std::map<ECS::EntityId, std::set<ECS::EntityId>> m_childrenMap;
-
-		void updateTransformsAndTheirChildrenRecursively(ECS::Registry& registry, ECS::EntityId entityId);
 	};
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "World.h"
 #include <Core/System/SystemContainer.h>
 #include <Core/TransformSystem.h>
+#include <algorithm>
+#include <chrono>
 
 using namespace Mani;
 
@@ -41,10 +43,51 @@ void World::deinitialize()
 
 void World::tick(float deltaTime)
 {
-	m_systemContainer->tick(deltaTime);
+	tickGroups(deltaTime, ETickGroup::PreTick, ETickGroup::PostTick);
+}
+
+void World::tickGroups(float deltaTime, ETickGroup firstTickGroup, ETickGroup lastTickGroup)
+{
+	const auto start = std::chrono::steady_clock::now();
+	m_systemContainer->tick(deltaTime, firstTickGroup, lastTickGroup);
+	m_currentTickDuration += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	if (lastTickGroup != ETickGroup::PostTick)
+	{
+		return;
+	}
+
+	const float tickDuration = m_currentTickDuration;
+	m_currentTickDuration = 0.0f;
+
+	// the first tick seeds the average.
+	const float averageWeight = 0.1f;
+	m_tickStatistics.averageTickDuration = m_tickStatistics.tickCount == 0 ? tickDuration : m_tickStatistics.averageTickDuration + (tickDuration - m_tickStatistics.averageTickDuration) * averageWeight;
+	m_tickStatistics.lastTickDuration = tickDuration;
+	m_tickStatistics.maxTickDuration = std::max(m_tickStatistics.maxTickDuration, tickDuration);
+	m_tickStatistics.tickCount++;
+	if (m_tickBudget > 0.0f && tickDuration > m_tickBudget)
+	{
+		m_tickStatistics.overBudgetTickCount++;
+	}
 }
 
 SystemContainer& World::getSystemContainer()
 {
 	return *m_systemContainer;
 }
+
+void World::setTickBudget(float budget)
+{
+	m_tickBudget = budget;
+}
+
+float World::getTickBudget() const
+{
+	return m_tickBudget;
+}
+
+const WorldTickStatistics& World::getTickStatistics() const
+{
+	return m_tickStatistics;
+}
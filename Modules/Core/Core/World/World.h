@@ -1,12 +1,25 @@
 #pragma once
 
 #include <Core/Core.h>
+#include <Core/System/System.h>
 #include <ECS/Registry.h>
 
 namespace Mani
 {
 	class SystemContainer;
 
+	// durations are in milliseconds.
+	struct WorldTickStatistics
+	{
+		uint64_t tickCount = 0;
+		float lastTickDuration = 0.0f;
+		// moving average over the latest ticks.
+		float averageTickDuration = 0.0f;
+		float maxTickDuration = 0.0f;
+		// amount of ticks that took longer than the world's tick budget.
+		uint64_t overBudgetTickCount = 0;
+	};
+
 	class World
 	{
 	public:
@@ -18,10 +31,23 @@ namespace Mani
 		bool isInitialized() const { return m_isInitialized; }
 
 		virtual void tick(float deltaTime);
+		// ticks the tick groups in [firstTickGroup, lastTickGroup]. A tick is counted in the statistics once its PostTick group ticked.
+		void tickGroups(float deltaTime, ETickGroup firstTickGroup, ETickGroup lastTickGroup);
 		SystemContainer& getSystemContainer();
 
+		// a tick longer than budget milliseconds counts as over budget. 0 disables the budget.
+		void setTickBudget(float budget);
+		float getTickBudget() const;
+
+		const WorldTickStatistics& getTickStatistics() const;
+
 	private:
 		SystemContainer* m_systemContainer = nullptr;
 		bool m_isInitialized = false;
+
+		float m_tickBudget = 0.0f;
+		WorldTickStatistics m_tickStatistics;
+		// time spent in the tick groups of the current tick so far.
+		float m_currentTickDuration = 0.0f;
 	};
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "WorldSystem.h"
 #include <Core/World/World.h>
+#include <Core/System/SystemContainer.h>
+#include <algorithm>
 #include <vector>
 
 using namespace Mani;
@@ -11,8 +13,11 @@ void WorldSystem::onInitialize(ECS::Registry& registry, SystemContainer& systemC
 		return;
 	}
 
+	m_jobSystem = systemContainer.getJobSystem();
+	m_fixedTimestep = &systemContainer.getFixedTimestep();
 	for (auto& world : m_worlds)
 	{
+		world->getSystemContainer().setJobSystem(m_jobSystem);
 		world->initialize();
 	}
 }
@@ -33,6 +38,13 @@ void WorldSystem::onDeinitialize(ECS::Registry& registry)
 std::shared_ptr<World> WorldSystem::createWorld()
 {
 	std::shared_ptr<World> world = std::make_shared<World>();
+	world->getSystemContainer().setJobSystem(m_jobSystem);
+	if (m_fixedTimestep != nullptr)
+	{
+		FixedTimestep& fixedTimestep = world->getSystemContainer().getFixedTimestep();
+		fixedTimestep.setStepDuration(m_fixedTimestep->getStepDuration());
+		fixedTimestep.setMaxStepCount(m_fixedTimestep->getMaxStepCount());
+	}
 	m_worlds.push_back(world);
 	world->initialize();
 	return world;
@@ -54,10 +66,52 @@ std::shared_ptr<World> WorldSystem::getRelevantWorld() const
 	return m_relevantWorld;
 }
 
+void WorldSystem::setParallelTicking(bool isEnabled)
+{
+	m_isParallelTicking = isEnabled;
+}
+
+bool WorldSystem::isParallelTicking() const
+{
+	return m_isParallelTicking;
+}
+
 void WorldSystem::tick(float deltaTime, ECS::Registry& registry)
 {
+	if (!m_isParallelTicking || m_jobSystem == nullptr || m_worlds.size() < 2)
+	{
+		for (auto& world : m_worlds)
+		{
+			world->tick(deltaTime);
+		}
+		return;
+	}
+
+	// the slowest worlds are stolen first, so they do not end the frame alone.
+	std::vector<World*> worlds;
+	worlds.reserve(m_worlds.size());
+	for (auto& world : m_worlds)
+	{
+		worlds.push_back(world.get());
+	}
+	std::stable_sort(worlds.begin(), worlds.end(), [](const World* lhs, const World* rhs)
+	{
+		return lhs->getTickStatistics().lastTickDuration > rhs->getTickStatistics().lastTickDuration;
+	});
+
+	JobCounter counter;
+	for (World* world : worlds)
+	{
+		m_jobSystem->schedule([world, deltaTime]()
+		{
+			world->tickGroups(deltaTime, ETickGroup::PreTick, ETickGroup::Tick);
+		}, &counter);
+	}
+	m_jobSystem->wait(counter);
+
+	// every world is done with its Tick group.
 	for (auto& world : m_worlds)
 	{
-		world->tick(deltaTime);
+		world->tickGroups(deltaTime, ETickGroup::PostTick, ETickGroup::PostTick);
 	}
 }
@@ -9,6 +9,8 @@
 namespace Mani
 {
 	class World;
+	class JobSystem;
+	class FixedTimestep;
 
 	class WorldSystem : public SystemBase
 	{
@@ -26,11 +28,22 @@ namespace Mani
 		void setRelevantWorld(const std::shared_ptr<World>& world);
 		std::shared_ptr<World> getRelevantWorld() const;
 
+		// when enabled, the worlds tick their tick groups up to Tick in parallel on the job system. Once every world is
+		// done, they tick their PostTick group one after another on the calling thread: PostTick systems can read other worlds.
+		// Worlds are expected not to share data before PostTick, they are ticked with World::tickGroups. Disabled by default.
+		void setParallelTicking(bool isEnabled);
+		bool isParallelTicking() const;
+
 		virtual void tick(float deltaTime, ECS::Registry& registry) override;
 
 	private:
 
 		std::vector<std::shared_ptr<World>> m_worlds;
 		std::shared_ptr<World> m_relevantWorld = nullptr;
+		// the job system of the container owning the WorldSystem, the worlds' systems tick on it too.
+		JobSystem* m_jobSystem = nullptr;
+		// the fixed timestep of the container owning the WorldSystem, new worlds step at its rate.
+		const FixedTimestep* m_fixedTimestep = nullptr;
+		bool m_isParallelTicking = false;
 	};
 }
\ No newline at end of file
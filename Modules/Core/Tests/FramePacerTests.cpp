@@ -0,0 +1,94 @@
+#include <Core/FramePacer.h>
+#include <Core/Application.h>
+#include <Core/System/SystemContainer.h>
+#include <ManiTests/ManiTests.h>
+#include <chrono>
+#include <thread>
+
+using namespace Mani;
+
+namespace Mani_Test
+{
+	class StopAfterFramesSystem : public SystemBase
+	{
+	public:
+		virtual bool shouldTick(ECS::Registry& registry) const override { return true; }
+
+		virtual void tick(float deltaTime, ECS::Registry& registry) override
+		{
+			tickCount++;
+			if (tickCount == 2)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(40));
+			}
+			if (tickCount == 5)
+			{
+				Application::get().stop();
+			}
+		}
+
+		int tickCount = 0;
+	};
+}
+
+MANI_SECTION_BEGIN(FramePacerSection, "Frame Pacer")
+{
+	MANI_TEST(PaceAtTargetRate, "Frames should last as long as the target rate allows")
+	{
+		using Clock = std::chrono::steady_clock;
+
+		FramePacer framePacer;
+		framePacer.setTargetRate(100.0f);
+		MANI_TEST_ASSERT(framePacer.getTargetFrameDuration() == 10.0f, "A frame at 100 frames per second should last 10ms");
+
+		const Clock::time_point start = Clock::now();
+		for (int i = 0; i < 10; ++i)
+		{
+			MANI_TEST_ASSERT(framePacer.waitForNextFrame(), "An empty frame should not overrun");
+		}
+		const float elapsed = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+		MANI_TEST_ASSERT(elapsed >= 99.0f && elapsed < 150.0f, "10 frames should last about 100ms");
+	}
+
+	MANI_TEST(FrameOverrun, "A frame longer than the target frame duration should be reported, then the pacing should restart")
+	{
+		FramePacer framePacer;
+		framePacer.setTargetRate(100.0f);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		MANI_TEST_ASSERT(!framePacer.waitForNextFrame(), "The frame should have overrun");
+		MANI_TEST_ASSERT(framePacer.getLastFrameDuration() >= 20.0f, "The frame duration should include the frame's work");
+		MANI_TEST_ASSERT(framePacer.waitForNextFrame(), "The next frame should not have to catch up");
+	}
+
+	MANI_TEST(UnpacedFrames, "Without a target rate, frames should not wait")
+	{
+		FramePacer framePacer;
+		for (int i = 0; i < 100; ++i)
+		{
+			MANI_TEST_ASSERT(framePacer.waitForNextFrame(), "An unpaced frame should never overrun");
+		}
+		MANI_TEST_ASSERT(framePacer.getTargetFrameDuration() == 0.0f, "An unpaced frame should have no target duration");
+	}
+
+	MANI_TEST(ApplicationFrameOverrun, "Application::run should broadcast its overrun frames")
+	{
+		using namespace Mani_Test;
+
+		Application app;
+		app.setTargetTickRate(100.0f);
+		app.getSystemContainer().createSystem<StopAfterFramesSystem>();
+
+		int overrunCount = 0;
+		app.onFrameOverrun.subscribe([&overrunCount](float frameDuration, float targetFrameDuration)
+		{
+			MANI_TEST_ASSERT(frameDuration > targetFrameDuration, "An overrun frame should be longer than the target");
+			overrunCount++;
+		});
+
+		app.run();
+		std::shared_ptr<StopAfterFramesSystem> system = app.getSystemContainer().getSystem<StopAfterFramesSystem>().lock();
+		MANI_TEST_ASSERT(system != nullptr && system->tickCount == 5, "The application should have ticked until stopped");
+		MANI_TEST_ASSERT(overrunCount == 1, "Only the slow frame should have overrun");
+	}
+}
+MANI_SECTION_END(FramePacerSection)
@@ -0,0 +1,197 @@
+#include <Core/Jobs/JobSystem.h>
+#include <ECS/Registry.h>
+#include <ECS/View.h>
+#include <ECS/ParallelFor.h>
+#include <ManiTests/ManiTests.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Mani;
+
+MANI_SECTION_BEGIN(JobSystemSection, "Job System")
+{
+	MANI_TEST(ScheduleAndWait, "Should run every scheduled job once before wait returns")
+	{
+		for (const size_t workerCount : { 0, 1, 4 })
+		{
+			JobSystem jobSystem(workerCount);
+			MANI_TEST_ASSERT(jobSystem.getWorkerCount() == workerCount, "The job system should start the requested workers");
+
+			std::atomic<size_t> runCount = 0;
+			JobCounter counter;
+			for (int i = 0; i < 1000; ++i)
+			{
+				jobSystem.schedule([&runCount]() { runCount++; }, &counter);
+			}
+			jobSystem.wait(counter);
+			MANI_TEST_ASSERT(counter.isDone() && runCount == 1000, "Every job should have run");
+		}
+	}
+
+	MANI_TEST(NestedJobs, "Jobs should schedule and wait on other jobs without deadlocking")
+	{
+		JobSystem jobSystem(2);
+		std::atomic<size_t> runCount = 0;
+		JobCounter counter;
+		for (int i = 0; i < 16; ++i)
+		{
+			jobSystem.schedule([&jobSystem, &runCount]()
+			{
+				// waiting in a job runs other jobs instead of blocking the worker.
+				JobCounter childCounter;
+				for (int j = 0; j < 16; ++j)
+				{
+					jobSystem.schedule([&runCount]() { runCount++; }, &childCounter);
+				}
+				jobSystem.wait(childCounter);
+				runCount++;
+			}, &counter);
+		}
+		jobSystem.wait(counter);
+		MANI_TEST_ASSERT(runCount == 16 * 17, "Every nested job should have run");
+	}
+
+	MANI_TEST(Dependencies, "Jobs scheduled after a counter should only run once it is done")
+	{
+		JobSystem jobSystem(4);
+		std::atomic<size_t> firstStageCount = 0;
+		std::atomic<size_t> secondStageCount = 0;
+		std::atomic<bool> isOrderRespected = true;
+
+		JobCounter firstStage;
+		JobCounter secondStage;
+		for (int i = 0; i < 64; ++i)
+		{
+			jobSystem.schedule([&firstStageCount]() { firstStageCount++; }, &firstStage);
+		}
+		for (int i = 0; i < 64; ++i)
+		{
+			jobSystem.scheduleAfter(firstStage, [&firstStageCount, &secondStageCount, &isOrderRespected]()
+			{
+				if (firstStageCount != 64)
+				{
+					isOrderRespected = false;
+				}
+				secondStageCount++;
+			}, &secondStage);
+		}
+
+		jobSystem.wait(secondStage);
+		MANI_TEST_ASSERT(isOrderRespected, "Continuations should run after their dependency");
+		MANI_TEST_ASSERT(secondStageCount == 64, "Every continuation should have run");
+
+		// a dependency that is already done queues the job right away.
+		JobCounter thirdStage;
+		jobSystem.scheduleAfter(secondStage, [&secondStageCount]() { secondStageCount++; }, &thirdStage);
+		jobSystem.wait(thirdStage);
+		MANI_TEST_ASSERT(secondStageCount == 65, "A job after a done counter should run");
+	}
+
+	MANI_TEST(ParallelFor, "parallelFor should visit every batch and range exactly once")
+	{
+		for (const size_t workerCount : { 0, 3 })
+		{
+			JobSystem jobSystem(workerCount);
+			std::vector<std::atomic<int>> visits(10'000);
+			jobSystem.parallelFor(visits.size(), [&visits](size_t batchIndex)
+			{
+				visits[batchIndex]++;
+			});
+
+			bool isVisitedOnce = true;
+			for (std::atomic<int>& visit : visits)
+			{
+				isVisitedOnce &= visit == 1;
+			}
+			MANI_TEST_ASSERT(isVisitedOnce, "Every batch should be visited once");
+
+			std::atomic<size_t> sum = 0;
+			jobSystem.parallelFor(1001, 64, [&sum](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					sum += i;
+				}
+			});
+			MANI_TEST_ASSERT(sum == 1000 * 1001 / 2, "Every index of the ranges should be visited once");
+		}
+	}
+
+	MANI_TEST(ExternalThreadsStress, "Jobs scheduled from several threads at once should all run")
+	{
+		JobSystem jobSystem(4);
+		std::atomic<size_t> runCount = 0;
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t)
+		{
+			threads.emplace_back([&jobSystem, &runCount]()
+			{
+				for (int round = 0; round < 50; ++round)
+				{
+					JobCounter counter;
+					for (int i = 0; i < 100; ++i)
+					{
+						jobSystem.schedule([&runCount]() { runCount++; }, &counter);
+					}
+					jobSystem.wait(counter);
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		MANI_TEST_ASSERT(runCount == 4 * 50 * 100, "Every job should have run");
+	}
+
+	MANI_TEST(DestroyWithQueuedJobs, "Destroying the job system should run the jobs nobody waited on")
+	{
+		std::atomic<size_t> runCount = 0;
+		{
+			JobSystem jobSystem(0);
+			for (int i = 0; i < 10; ++i)
+			{
+				jobSystem.schedule([&runCount]() { runCount++; });
+			}
+		}
+		MANI_TEST_ASSERT(runCount == 10, "Queued jobs should run before the job system is destroyed");
+	}
+
+	MANI_TEST(ECSParallelFor, "View::parallelEach should run on the job system once plugged in the ECS")
+	{
+		struct DataComponent
+		{
+			int someData = 0;
+		};
+
+		JobSystem jobSystem(3);
+		std::atomic<size_t> dispatchCount = 0;
+		ECS::setParallelFor([&jobSystem, &dispatchCount](size_t batchCount, const std::function<void(size_t)>& function)
+		{
+			dispatchCount++;
+			jobSystem.parallelFor(batchCount, function);
+		});
+
+		ECS::Registry registry;
+		std::vector<ECS::EntityId> entityIds;
+		registry.createMany(10'000, entityIds);
+		registry.emplaceMany<DataComponent>(entityIds);
+
+		ECS::View<DataComponent>(registry).parallelEach([](ECS::EntityId entityId, DataComponent& data)
+		{
+			data.someData++;
+		}, 128);
+		ECS::setParallelFor(nullptr);
+
+		bool isVisitedOnce = true;
+		for (const ECS::EntityId entityId : entityIds)
+		{
+			isVisitedOnce &= registry.get<DataComponent>(entityId)->someData == 1;
+		}
+		MANI_TEST_ASSERT(dispatchCount == 1 && isVisitedOnce, "Every entity should be visited once through the job system");
+	}
+}
+MANI_SECTION_END(JobSystemSection)
@@ -0,0 +1,226 @@
+#include <Core/System/SystemContainer.h>
+#include <Core/Jobs/JobSystem.h>
+#include <ManiTests/ManiTests.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace Mani;
+
+namespace Mani_Test
+{
+	struct ScheduledPosition
+	{
+		float x = 0.0f;
+	};
+
+	struct ScheduledVelocity
+	{
+		float x = 0.0f;
+	};
+
+	// shared by the systems below, reset by each test.
+	struct SchedulingRecord
+	{
+		inline static std::atomic<int> startedCount = 0;
+		inline static std::atomic<bool> isWriterDone = false;
+		inline static std::atomic<bool> didOverlap = false;
+		inline static std::atomic<bool> didReadAfterWrite = false;
+		inline static std::atomic<bool> didTickAlone = false;
+		inline static std::thread::id exclusiveThreadId;
+
+		static void reset()
+		{
+			startedCount = 0;
+			isWriterDone = false;
+			didOverlap = false;
+			didReadAfterWrite = false;
+			didTickAlone = false;
+			exclusiveThreadId = std::thread::id();
+		}
+
+		// returns true if count systems started before the timeout.
+		static bool waitForStartedCount(int count)
+		{
+			const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+			while (startedCount < count)
+			{
+				if (std::chrono::steady_clock::now() > timeout)
+				{
+					return false;
+				}
+				std::this_thread::yield();
+			}
+			return true;
+		}
+	};
+
+	class PositionWriterSystem : public SystemBase
+	{
+	public:
+		virtual bool shouldTick(ECS::Registry& registry) const override { return true; }
+
+		virtual bool declareAccess(SystemAccess& access) const override
+		{
+			access.write<ScheduledPosition>();
+			return true;
+		}
+
+		virtual void tick(float deltaTime, ECS::Registry& registry) override
+		{
+			SchedulingRecord::startedCount++;
+			if (SchedulingRecord::waitForStartedCount(2))
+			{
+				SchedulingRecord::didOverlap = true;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			SchedulingRecord::isWriterDone = true;
+		}
+	};
+
+	class VelocityWriterSystem : public SystemBase
+	{
+	public:
+		virtual bool shouldTick(ECS::Registry& registry) const override { return true; }
+
+		virtual bool declareAccess(SystemAccess& access) const override
+		{
+			access.read<ScheduledPosition>()
+				.write<ScheduledVelocity>();
+			return true;
+		}
+
+		virtual void tick(float deltaTime, ECS::Registry& registry) override
+		{
+			SchedulingRecord::didReadAfterWrite = SchedulingRecord::isWriterDone.load();
+		}
+	};
+
+	class VelocityOnlySystem : public SystemBase
+	{
+	public:
+		virtual bool shouldTick(ECS::Registry& registry) const override { return true; }
+
+		virtual bool declareAccess(SystemAccess& access) const override
+		{
+			access.write<ScheduledVelocity>();
+			return true;
+		}
+
+		virtual void tick(float deltaTime, ECS::Registry& registry) override
+		{
+			SchedulingRecord::startedCount++;
+			SchedulingRecord::waitForStartedCount(2);
+		}
+	};
+
+	class UndeclaredSystem : public SystemBase
+	{
+	public:
+		virtual bool shouldTick(ECS::Registry& registry) const override { return true; }
+
+		virtual void tick(float deltaTime, ECS::Registry& registry) override
+		{
+			SchedulingRecord::exclusiveThreadId = std::this_thread::get_id();
+			SchedulingRecord::didTickAlone = SchedulingRecord::isWriterDone.load();
+		}
+	};
+}
+
+MANI_SECTION_BEGIN(SystemScheduling, "System Scheduling")
+{
+	MANI_TEST(SystemAccessConflicts, "Systems should conflict when one of them writes a component the other one uses")
+	{
+		using namespace Mani_Test;
+
+		ECS::Registry registry;
+		SystemAccess positionWriter(registry);
+		positionWriter.write<ScheduledPosition>();
+		SystemAccess positionReader(registry);
+		positionReader.read<ScheduledPosition>();
+		SystemAccess otherPositionReader(registry);
+		otherPositionReader.read<ScheduledPosition>();
+		SystemAccess velocityWriter(registry);
+		velocityWriter.write<ScheduledVelocity>();
+
+		MANI_TEST_ASSERT(positionWriter.conflictsWith(positionReader) && positionReader.conflictsWith(positionWriter), "A writer should conflict with a reader");
+		MANI_TEST_ASSERT(positionWriter.conflictsWith(positionWriter), "Two writers should conflict");
+		MANI_TEST_ASSERT(!positionReader.conflictsWith(otherPositionReader), "Readers should not conflict");
+		MANI_TEST_ASSERT(!positionWriter.conflictsWith(velocityWriter), "Systems using different components should not conflict");
+	}
+
+	MANI_TEST(DisjointSystemsTickConcurrently, "Systems writing different components should tick at the same time")
+	{
+		using namespace Mani_Test;
+
+		JobSystem jobSystem(2);
+		SystemContainer systemContainer;
+		systemContainer.setJobSystem(&jobSystem);
+		systemContainer.initialize();
+		systemContainer.createSystem<PositionWriterSystem>()
+			.createSystem<VelocityOnlySystem>();
+
+		SchedulingRecord::reset();
+		systemContainer.tick(0.0f);
+		MANI_TEST_ASSERT(SchedulingRecord::didOverlap, "Both systems should have been ticking at the same time");
+		systemContainer.deinitialize();
+	}
+
+	MANI_TEST(ConflictingSystemsTickInOrder, "A system reading a component should tick after the earlier system writing it")
+	{
+		using namespace Mani_Test;
+
+		JobSystem jobSystem(2);
+		SystemContainer systemContainer;
+		systemContainer.setJobSystem(&jobSystem);
+		systemContainer.initialize();
+		systemContainer.createSystem<PositionWriterSystem>()
+			.createSystem<VelocityWriterSystem>()
+			.createSystem<VelocityOnlySystem>();
+
+		for (int i = 0; i < 10; ++i)
+		{
+			SchedulingRecord::reset();
+			systemContainer.tick(0.0f);
+			MANI_TEST_ASSERT(SchedulingRecord::didReadAfterWrite, "The reader should tick once the writer is done");
+		}
+		systemContainer.deinitialize();
+	}
+
+	MANI_TEST(UndeclaredSystemsTickAlone, "A system not declaring its access should tick alone, on the calling thread")
+	{
+		using namespace Mani_Test;
+
+		JobSystem jobSystem(2);
+		SystemContainer systemContainer;
+		systemContainer.setJobSystem(&jobSystem);
+		systemContainer.initialize();
+		systemContainer.createSystem<PositionWriterSystem>()
+			.createSystem<VelocityOnlySystem>()
+			.createSystem<UndeclaredSystem>();
+
+		SchedulingRecord::reset();
+		systemContainer.tick(0.0f);
+		MANI_TEST_ASSERT(SchedulingRecord::didTickAlone, "The undeclared system should tick after the earlier systems");
+		MANI_TEST_ASSERT(SchedulingRecord::exclusiveThreadId == std::this_thread::get_id(), "The undeclared system should tick on the calling thread");
+		systemContainer.deinitialize();
+	}
+
+	MANI_TEST(TickWithoutJobSystem, "Without a job system, systems should tick in creation order on the calling thread")
+	{
+		using namespace Mani_Test;
+
+		SystemContainer systemContainer;
+		systemContainer.initialize();
+		systemContainer.createSystem<PositionWriterSystem>()
+			.createSystem<VelocityWriterSystem>()
+			.createSystem<UndeclaredSystem>();
+
+		SchedulingRecord::reset();
+		systemContainer.tick(0.0f);
+		MANI_TEST_ASSERT(!SchedulingRecord::didOverlap, "No system should tick concurrently");
+		MANI_TEST_ASSERT(SchedulingRecord::didReadAfterWrite && SchedulingRecord::didTickAlone, "Systems should tick in creation order");
+		MANI_TEST_ASSERT(SchedulingRecord::exclusiveThreadId == std::this_thread::get_id(), "Systems should tick on the calling thread");
+		systemContainer.deinitialize();
+	}
+}
@@ -1,5 +1,6 @@
 #include <Core/CoreFwd.h>
 #include <ManiTests/ManiTests.h>
+#include <ECS/Hierarchy.h>
 
 using namespace Mani;
 
@@ -30,7 +31,7 @@ MANI_SECTION_BEGIN(TransformSystemSection, "TransformSystem")
 			parentTransform = registry.get<Transform>(parentId);
 			childTransform = registry.get<Transform>(childId);
 
-			childTransform->parentId = parentId;
+			ECS::setParent(registry, childId, parentId);
 			childTransform->localPosition = glm::vec3(5.f, 0.f, 0.f);
 		}
 
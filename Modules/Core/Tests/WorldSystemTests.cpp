@@ -1,12 +1,66 @@
 #include <Core/Application.h>
 #include <Core/System/SystemContainer.h>
 #include <Core/World/WorldSystem.h>
+#include <Core/Jobs/JobSystem.h>
 #include <Events/Event.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 #include <ManiTests/ManiTests.h>
 
 using namespace Mani;
 
+namespace Mani_Test
+{
+	struct ParallelWorldsRecord
+	{
+		inline static std::atomic<int> startedCount = 0;
+		inline static std::atomic<int> tickedCount = 0;
+		inline static std::atomic<bool> didOverlap = false;
+		inline static std::atomic<int> mergedCount = 0;
+		inline static std::atomic<bool> didPostTickOnCallingThread = true;
+		inline static std::thread::id callingThreadId;
+	};
+
+	class ParallelWorldTickSystem : public SystemBase
+	{
+	public:
+		virtual bool shouldTick(ECS::Registry& registry) const override { return true; }
+
+		virtual void tick(float deltaTime, ECS::Registry& registry) override
+		{
+			ParallelWorldsRecord::startedCount++;
+			const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+			while (ParallelWorldsRecord::startedCount < 2 && std::chrono::steady_clock::now() < timeout)
+			{
+				std::this_thread::yield();
+			}
+			ParallelWorldsRecord::didOverlap = ParallelWorldsRecord::startedCount >= 2;
+			ParallelWorldsRecord::tickedCount++;
+		}
+	};
+
+	class ParallelWorldPostTickSystem : public SystemBase
+	{
+	public:
+		virtual bool shouldTick(ECS::Registry& registry) const override { return true; }
+		virtual ETickGroup getTickGroup() const override { return ETickGroup::PostTick; }
+
+		virtual void tick(float deltaTime, ECS::Registry& registry) override
+		{
+			if (ParallelWorldsRecord::tickedCount == 2)
+			{
+				ParallelWorldsRecord::mergedCount++;
+			}
+			if (std::this_thread::get_id() != ParallelWorldsRecord::callingThreadId)
+			{
+				ParallelWorldsRecord::didPostTickOnCallingThread = false;
+			}
+		}
+	};
+}
+
 MANI_SECTION_BEGIN(WorldSystemSection, "WorldSytem")
 {
 	MANI_TEST(WorldSystemCreate, "Should create an Application and setup a world")
@@ -50,5 +104,37 @@ MANI_SECTION_BEGIN(WorldSystemSection, "WorldSytem")
 		app.tick(0.f);
 		MANI_TEST_ASSERT(hasTicked, "World should have ticked.");
 	}
+
+	MANI_TEST(ParallelWorldTicking, "Worlds should tick in parallel, then tick their PostTick group once every world is done")
+	{
+		using namespace Mani_Test;
+
+		JobSystem jobSystem(2);
+		SystemContainer systemContainer;
+		systemContainer.setJobSystem(&jobSystem);
+		systemContainer.initialize();
+		systemContainer.createSystem<WorldSystem>();
+		std::shared_ptr<WorldSystem> worldSystem = systemContainer.getSystem<WorldSystem>().lock();
+		worldSystem->setParallelTicking(true);
+
+		std::shared_ptr<World> worlds[] = { worldSystem->createWorld(), worldSystem->createWorld() };
+		for (const std::shared_ptr<World>& world : worlds)
+		{
+			world->getSystemContainer().createSystem<ParallelWorldTickSystem>()
+				.createSystem<ParallelWorldPostTickSystem>();
+		}
+
+		ParallelWorldsRecord::callingThreadId = std::this_thread::get_id();
+		systemContainer.tick(0.f);
+		MANI_TEST_ASSERT(ParallelWorldsRecord::didOverlap, "Both worlds should have been ticking at the same time");
+		MANI_TEST_ASSERT(ParallelWorldsRecord::mergedCount == 2, "PostTick should tick once every world ticked");
+		MANI_TEST_ASSERT(ParallelWorldsRecord::didPostTickOnCallingThread, "PostTick should tick on the calling thread");
+		for (const std::shared_ptr<World>& world : worlds)
+		{
+			MANI_TEST_ASSERT(world->getTickStatistics().tickCount == 1, "Each world should have counted its tick");
+		}
+
+		systemContainer.deinitialize();
+	}
 }
 MANI_SECTION_END(WorldSystemSection)
@@ -1,6 +1,10 @@
 #include <Core/World/World.h>
 #include <Core/System/SystemContainer.h>
+#include <ECS/View.h>
 #include <Events/Event.h>
+#include <chrono>
+#include <cmath>
+#include <thread>
 
 #include <ManiTests/ManiTests.h>
 
@@ -341,5 +345,185 @@ MANI_SECTION_BEGIN(Core_World, "Core World")
 		
 		someFunctionalitySystem->DoFunctionality();
 	}
+
+	MANI_TEST(CommandBufferFlushedBetweenTickGroups, "Structural changes recorded in a tick group should be applied before the next tick group")
+	{
+		struct SpawnedComponent
+		{
+			int value = 0;
+		};
+
+		class SpawnerSystem : public SystemBase
+		{
+		public:
+			virtual ETickGroup getTickGroup() const override { return ETickGroup::PreTick; }
+			virtual bool shouldTick(ECS::Registry& registry) const override { return true; }
+
+			virtual void onInitialize(ECS::Registry& registry, SystemContainer& systemContainer) override
+			{
+				commandBuffer = &systemContainer.getCommandBuffer();
+			}
+
+			virtual void tick(float deltaTime, ECS::Registry& registry) override
+			{
+				const ECS::EntityId entityId = commandBuffer->create();
+				commandBuffer->add<SpawnedComponent>(entityId, SpawnedComponent{ 42 });
+				sizeDuringTick = registry.size();
+			}
+
+			ECS::CommandBuffer* commandBuffer = nullptr;
+			size_t sizeDuringTick = 0;
+		};
+
+		class ReaderSystem : public SystemBase
+		{
+		public:
+			virtual bool shouldTick(ECS::Registry& registry) const override { return true; }
+
+			virtual void tick(float deltaTime, ECS::Registry& registry) override
+			{
+				spawnedCount = 0;
+				ECS::View<SpawnedComponent>(registry).each([this](ECS::EntityId entityId, SpawnedComponent& spawned)
+				{
+					spawnedCount += spawned.value == 42 ? 1 : 0;
+				});
+			}
+
+			size_t spawnedCount = 0;
+		};
+
+		World world;
+		SystemContainer& systemContainer = world.getSystemContainer();
+		systemContainer.createSystem<ReaderSystem>();
+		systemContainer.createSystem<SpawnerSystem>();
+		world.initialize();
+
+		std::shared_ptr<SpawnerSystem> spawnerSystem = systemContainer.getSystem<SpawnerSystem>().lock();
+		std::shared_ptr<ReaderSystem> readerSystem = systemContainer.getSystem<ReaderSystem>().lock();
+		if (spawnerSystem == nullptr || readerSystem == nullptr)
+		{
+			MANI_TEST_ASSERT(false, "did not create the systems, should have created the systems");
+			return;
+		}
+
+		world.tick(.16f);
+		const size_t sizeAfterFirstTick = spawnerSystem->sizeDuringTick;
+		MANI_TEST_ASSERT(readerSystem->spawnedCount == 1, "The entity spawned in PreTick should be visible in Tick");
+
+		world.tick(.16f);
+		MANI_TEST_ASSERT(spawnerSystem->sizeDuringTick == sizeAfterFirstTick + 1, "The registry should not change while the spawner records");
+		MANI_TEST_ASSERT(readerSystem->spawnedCount == 2, "Each tick should spawn one entity");
+		MANI_TEST_ASSERT(systemContainer.getCommandBuffer().isEmpty(), "The command buffer should be flushed at the end of the tick");
+
+		world.deinitialize();
+	}
+
+	MANI_TEST(TickStatistics, "Should count a world tick once its PostTick group ticked")
+	{
+		class SlowSystem : public SystemBase
+		{
+		public:
+			virtual bool shouldTick(ECS::Registry& registry) const override { return true; }
+
+			virtual void tick(float deltaTime, ECS::Registry& registry) override
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			}
+		};
+
+		World world;
+		world.getSystemContainer().createSystem<SlowSystem>();
+		world.initialize();
+		world.setTickBudget(1.0f);
+
+		world.tickGroups(.16f, ETickGroup::PreTick, ETickGroup::Tick);
+		MANI_TEST_ASSERT(world.getTickStatistics().tickCount == 0, "The tick should not be counted before its PostTick group");
+
+		world.tickGroups(.16f, ETickGroup::PostTick, ETickGroup::PostTick);
+		const WorldTickStatistics& statistics = world.getTickStatistics();
+		MANI_TEST_ASSERT(statistics.tickCount == 1, "The tick should be counted once PostTick ticked");
+		MANI_TEST_ASSERT(statistics.lastTickDuration >= 2.0f && statistics.maxTickDuration == statistics.lastTickDuration, "The tick should last as long as its systems");
+		MANI_TEST_ASSERT(statistics.overBudgetTickCount == 1, "The tick should be over budget");
+
+		world.setTickBudget(0.0f);
+		world.tick(.16f);
+		MANI_TEST_ASSERT(statistics.tickCount == 2 && statistics.overBudgetTickCount == 1, "Without a budget, no tick should be over budget");
+
+		world.deinitialize();
+	}
+
+	MANI_TEST(FixedTimestepAccumulator, "Should turn frame durations into fixed steps and keep the remainder as the interpolation alpha")
+	{
+		FixedTimestep fixedTimestep;
+		fixedTimestep.setStepDuration(0.1f);
+		fixedTimestep.setMaxStepCount(3);
+
+		MANI_TEST_ASSERT(fixedTimestep.advance(0.05f) == 0, "Half a step should not run a step");
+		MANI_TEST_ASSERT(std::abs(fixedTimestep.getInterpolationAlpha() - 0.5f) < 0.001f, "Half a step should be accumulated");
+
+		MANI_TEST_ASSERT(fixedTimestep.advance(0.2f) == 2, "Two and a half steps should run two steps");
+		MANI_TEST_ASSERT(std::abs(fixedTimestep.getInterpolationAlpha() - 0.5f) < 0.001f, "The remainder should stay accumulated");
+
+		MANI_TEST_ASSERT(fixedTimestep.advance(1.0f) == 3, "A long frame should run at most the max step count");
+		MANI_TEST_ASSERT(fixedTimestep.getDroppedStepCount() == 7, "The steps past the max step count should be dropped");
+		MANI_TEST_ASSERT(fixedTimestep.getInterpolationAlpha() < 1.0f, "The alpha should stay below 1 after dropping steps");
+	}
+
+	MANI_TEST(FixedTickGroup, "FixedTick systems should tick once per fixed step with the step duration")
+	{
+		class FixedSystem : public SystemBase
+		{
+		public:
+			virtual bool shouldTick(ECS::Registry& registry) const override { return true; }
+			virtual ETickGroup getTickGroup() const override { return ETickGroup::FixedTick; }
+
+			virtual void tick(float deltaTime, ECS::Registry& registry) override
+			{
+				tickCount++;
+				lastDeltaTime = deltaTime;
+			}
+
+			int tickCount = 0;
+			float lastDeltaTime = 0.0f;
+		};
+
+		class FrameSystem : public SystemBase
+		{
+		public:
+			virtual bool shouldTick(ECS::Registry& registry) const override { return true; }
+
+			virtual void tick(float deltaTime, ECS::Registry& registry) override
+			{
+				tickCount++;
+			}
+
+			int tickCount = 0;
+		};
+
+		World world;
+		SystemContainer& systemContainer = world.getSystemContainer();
+		systemContainer.createSystem<FrameSystem>();
+		systemContainer.createSystem<FixedSystem>();
+		systemContainer.getFixedTimestep().setStepDuration(0.1f);
+		world.initialize();
+
+		std::shared_ptr<FixedSystem> fixedSystem = systemContainer.getSystem<FixedSystem>().lock();
+		std::shared_ptr<FrameSystem> frameSystem = systemContainer.getSystem<FrameSystem>().lock();
+		if (fixedSystem == nullptr || frameSystem == nullptr)
+		{
+			MANI_TEST_ASSERT(false, "did not create the systems, should have created the systems");
+			return;
+		}
+
+		world.tick(0.05f);
+		MANI_TEST_ASSERT(fixedSystem->tickCount == 0 && frameSystem->tickCount == 1, "A short frame should not run a fixed step");
+
+		world.tick(0.3f);
+		MANI_TEST_ASSERT(fixedSystem->tickCount == 3 && frameSystem->tickCount == 2, "A long frame should run several fixed steps");
+		MANI_TEST_ASSERT(std::abs(fixedSystem->lastDeltaTime - 0.1f) < 0.0001f, "Fixed steps should tick with the step duration");
+		MANI_TEST_ASSERT(std::abs(systemContainer.getFixedTimestep().getInterpolationAlpha() - 0.5f) < 0.001f, "The alpha should be the fraction of a step left");
+
+		world.deinitialize();
+	}
 }
 MANI_SECTION_END(Core_World)
\ No newline at end of file
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mani
+{
+	namespace Benchmarks
+	{
+		// keeps a value alive so the compiler does not optimize the measured work away.
+		template<typename TValue>
+		inline void doNotOptimize(const TValue& value)
+		{
+			static volatile uint64_t sink = 0;
+			sink = sink + static_cast<uint64_t>(value);
+		}
+
+		/*
+		 * Measures the time spent between start and stop. A benchmark prepares its data before start and
+		 * releases it after stop, only the work in between is measured.
+		 */
+		class Stopwatch
+		{
+		public:
+			void start()
+			{
+				m_start = std::chrono::steady_clock::now();
+			}
+
+			void stop()
+			{
+				m_elapsed += std::chrono::steady_clock::now() - m_start;
+			}
+
+			double getNanoseconds() const
+			{
+				return std::chrono::duration<double, std::nano>(m_elapsed).count();
+			}
+
+		private:
+			std::chrono::steady_clock::time_point m_start;
+			std::chrono::steady_clock::duration m_elapsed = std::chrono::steady_clock::duration::zero();
+		};
+
+		struct BenchmarkResult
+		{
+			std::string name;
+			// free form description of the benchmark's parameters, e.g. "sparsity=0.1".
+			std::string parameters;
+			size_t entityCount = 0;
+			// amount of operations measured by a repetition, nanoseconds per operation are derived from it.
+			size_t operationCount = 0;
+			size_t repetitionCount = 0;
+			double minNanoseconds = 0.0;
+			double medianNanoseconds = 0.0;
+			double maxNanoseconds = 0.0;
+
+			double getNanosecondsPerOperation() const
+			{
+				return operationCount > 0 ? medianNanoseconds / static_cast<double>(operationCount) : 0.0;
+			}
+		};
+
+		/*
+		 * Runs benchmarks a fixed amount of times and reports their min, median and max durations as JSON or CSV.
+		 */
+		class BenchmarkRunner
+		{
+		public:
+			BenchmarkRunner(size_t inRepetitionCount, std::string_view inFilter)
+				: m_repetitionCount(std::max<size_t>(inRepetitionCount, 1)),
+				m_filter(inFilter)
+			{
+			}
+
+			// runs function(stopwatch) once per repetition. Benchmarks whose name does not contain the filter are skipped.
+			template<typename TFunction>
+			void run(std::string_view name, std::string_view parameters, size_t entityCount, size_t operationCount, TFunction&& function)
+			{
+				if (!m_filter.empty() && name.find(m_filter) == std::string_view::npos)
+				{
+					return;
+				}
+
+				std::cerr << "Running " << name << " " << parameters << "\n";
+
+				std::vector<double> durations;
+				durations.reserve(m_repetitionCount);
+				for (size_t repetition = 0; repetition < m_repetitionCount; ++repetition)
+				{
+					Stopwatch stopwatch;
+					function(stopwatch);
+					durations.push_back(stopwatch.getNanoseconds());
+				}
+				std::sort(durations.begin(), durations.end());
+
+				BenchmarkResult result;
+				result.name = name;
+				result.parameters = parameters;
+				result.entityCount = entityCount;
+				result.operationCount = operationCount;
+				result.repetitionCount = m_repetitionCount;
+				result.minNanoseconds = durations.front();
+				result.medianNanoseconds = durations[durations.size() / 2];
+				result.maxNanoseconds = durations.back();
+				m_results.push_back(result);
+			}
+
+			void writeJson(std::ostream& stream) const
+			{
+				stream << std::fixed << std::setprecision(3);
+				stream << "{\n\t\"benchmarks\": [\n";
+				for (size_t i = 0; i < m_results.size(); ++i)
+				{
+					const BenchmarkResult& result = m_results[i];
+					stream << "\t\t{ "
+						<< "\"name\": \"" << result.name << "\", "
+						<< "\"parameters\": \"" << result.parameters << "\", "
+						<< "\"entities\": " << result.entityCount << ", "
+						<< "\"operations\": " << result.operationCount << ", "
+						<< "\"repetitions\": " << result.repetitionCount << ", "
+						<< "\"minNs\": " << result.minNanoseconds << ", "
+						<< "\"medianNs\": " << result.medianNanoseconds << ", "
+						<< "\"maxNs\": " << result.maxNanoseconds << ", "
+						<< "\"nsPerOperation\": " << result.getNanosecondsPerOperation()
+						<< " }" << (i + 1 < m_results.size() ? "," : "") << "\n";
+				}
+				stream << "\t]\n}\n";
+			}
+
+			void writeCsv(std::ostream& stream) const
+			{
+				stream << std::fixed << std::setprecision(3);
+				stream << "name,parameters,entities,operations,repetitions,minNs,medianNs,maxNs,nsPerOperation\n";
+				for (const BenchmarkResult& result : m_results)
+				{
+					stream << result.name << ","
+						<< result.parameters << ","
+						<< result.entityCount << ","
+						<< result.operationCount << ","
+						<< result.repetitionCount << ","
+						<< result.minNanoseconds << ","
+						<< result.medianNanoseconds << ","
+						<< result.maxNanoseconds << ","
+						<< result.getNanosecondsPerOperation() << "\n";
+				}
+			}
+
+		private:
+			size_t m_repetitionCount = 1;
+			std::string m_filter;
+			std::vector<BenchmarkResult> m_results;
+		};
+	}
+}
@@ -0,0 +1,541 @@
+#include "BenchmarkRunner.h"
+#include "WorkerPool.h"
+#include <ECS/Registry.h>
+#include <ECS/View.h>
+#include <ECS/Query.h>
+#include <ECS/ParallelFor.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Mani;
+using namespace Mani::Benchmarks;
+
+namespace
+{
+	struct Position
+	{
+		float x = 0.0f;
+		float y = 0.0f;
+		float z = 0.0f;
+	};
+
+	struct Velocity
+	{
+		float x = 1.0f;
+		float y = 1.0f;
+		float z = 1.0f;
+	};
+
+	struct Health
+	{
+		int value = 100;
+	};
+
+	struct Armor
+	{
+		int value = 10;
+	};
+
+	struct SparseComponent
+	{
+		static constexpr ECS::EComponentStorage storage = ECS::EComponentStorage::SparseSet;
+		float value = 0.0f;
+	};
+
+	// the same seed is used by every run so results are comparable.
+	const unsigned int RANDOM_SEED = 42;
+
+	float readComponent(const Position& position)
+	{
+		return position.x;
+	}
+
+	float readComponent(const SparseComponent& sparseComponent)
+	{
+		return sparseComponent.value;
+	}
+
+	std::string formatParameter(std::string_view name, double value)
+	{
+		std::string parameter(name);
+		parameter += "=";
+		parameter += std::to_string(value);
+		parameter.erase(parameter.find_last_not_of('0') + 1);
+		if (parameter.back() == '.')
+		{
+			parameter.pop_back();
+		}
+		return parameter;
+	}
+
+	// create and destroy begin
+
+	void runCreateDestroyBenchmarks(BenchmarkRunner& runner, size_t entityCount)
+	{
+		runner.run("CreateEntities", "", entityCount, entityCount, [entityCount](Stopwatch& stopwatch)
+		{
+			ECS::Registry registry;
+			stopwatch.start();
+			for (size_t i = 0; i < entityCount; ++i)
+			{
+				doNotOptimize(registry.create());
+			}
+			stopwatch.stop();
+		});
+
+		runner.run("CreateMany", "", entityCount, entityCount, [entityCount](Stopwatch& stopwatch)
+		{
+			ECS::Registry registry;
+			std::vector<ECS::EntityId> entityIds;
+			entityIds.reserve(entityCount);
+			stopwatch.start();
+			registry.createMany(entityCount, entityIds);
+			stopwatch.stop();
+		});
+
+		runner.run("DestroyEntities", "", entityCount, entityCount, [entityCount](Stopwatch& stopwatch)
+		{
+			ECS::Registry registry;
+			std::vector<ECS::EntityId> entityIds;
+			registry.createMany(entityCount, entityIds);
+			registry.emplaceMany<Position, Velocity>(entityIds);
+			stopwatch.start();
+			for (const ECS::EntityId entityId : entityIds)
+			{
+				registry.destroy(entityId);
+			}
+			stopwatch.stop();
+		});
+
+		runner.run("DestroyMany", "", entityCount, entityCount, [entityCount](Stopwatch& stopwatch)
+		{
+			ECS::Registry registry;
+			std::vector<ECS::EntityId> entityIds;
+			registry.createMany(entityCount, entityIds);
+			registry.emplaceMany<Position, Velocity>(entityIds);
+			stopwatch.start();
+			registry.destroyMany(entityIds);
+			stopwatch.stop();
+		});
+	}
+
+	// create and destroy end
+
+	// component access begin
+
+	template<typename TComponent>
+	void runComponentAccessBenchmarks(BenchmarkRunner& runner, std::string_view storageName, size_t entityCount)
+	{
+		const std::string parameters = std::string("storage=") + std::string(storageName);
+
+		runner.run("AddComponent", parameters, entityCount, entityCount, [entityCount](Stopwatch& stopwatch)
+		{
+			ECS::Registry registry;
+			std::vector<ECS::EntityId> entityIds;
+			registry.createMany(entityCount, entityIds);
+			stopwatch.start();
+			for (const ECS::EntityId entityId : entityIds)
+			{
+				doNotOptimize(registry.add<TComponent>(entityId) != nullptr);
+			}
+			stopwatch.stop();
+		});
+
+		// entities are visited in a random order, this is the latency of a lookup rather than a scan.
+		runner.run("GetComponent", parameters, entityCount, entityCount, [entityCount](Stopwatch& stopwatch)
+		{
+			ECS::Registry registry;
+			std::vector<ECS::EntityId> entityIds;
+			registry.createMany(entityCount, entityIds);
+			registry.emplaceMany<TComponent>(entityIds);
+			std::shuffle(entityIds.begin(), entityIds.end(), std::mt19937(RANDOM_SEED));
+
+			float sum = 0.0f;
+			stopwatch.start();
+			for (const ECS::EntityId entityId : entityIds)
+			{
+				sum += readComponent(*registry.get<TComponent>(entityId));
+			}
+			stopwatch.stop();
+			doNotOptimize(sum);
+		});
+
+		runner.run("HasComponent", parameters, entityCount, entityCount, [entityCount](Stopwatch& stopwatch)
+		{
+			ECS::Registry registry;
+			std::vector<ECS::EntityId> entityIds;
+			registry.createMany(entityCount, entityIds);
+			for (size_t i = 0; i < entityIds.size(); i += 2)
+			{
+				registry.add<TComponent>(entityIds[i]);
+			}
+			std::shuffle(entityIds.begin(), entityIds.end(), std::mt19937(RANDOM_SEED));
+
+			size_t count = 0;
+			stopwatch.start();
+			for (const ECS::EntityId entityId : entityIds)
+			{
+				count += registry.has<TComponent>(entityId) ? 1 : 0;
+			}
+			stopwatch.stop();
+			doNotOptimize(count);
+		});
+
+		runner.run("RemoveComponent", parameters, entityCount, entityCount, [entityCount](Stopwatch& stopwatch)
+		{
+			ECS::Registry registry;
+			std::vector<ECS::EntityId> entityIds;
+			registry.createMany(entityCount, entityIds);
+			registry.emplaceMany<TComponent>(entityIds);
+			std::shuffle(entityIds.begin(), entityIds.end(), std::mt19937(RANDOM_SEED));
+			stopwatch.start();
+			for (const ECS::EntityId entityId : entityIds)
+			{
+				registry.remove<TComponent>(entityId);
+			}
+			stopwatch.stop();
+		});
+	}
+
+	// component access end
+
+	// iteration begin
+
+	template<typename ...TComponents>
+	void runViewComponentCountBenchmark(BenchmarkRunner& runner, size_t entityCount)
+	{
+		const std::string parameters = formatParameter("components", static_cast<double>(sizeof...(TComponents)));
+		runner.run("ViewEachComponents", parameters, entityCount, entityCount, [entityCount](Stopwatch& stopwatch)
+		{
+			ECS::Registry registry;
+			std::vector<ECS::EntityId> entityIds;
+			registry.createMany(entityCount, entityIds);
+			registry.emplaceMany<Position, Velocity, Health, Armor>(entityIds);
+
+			size_t count = 0;
+			ECS::View<TComponents...> view(registry);
+			stopwatch.start();
+			view.each([&count](ECS::EntityId, TComponents&...)
+			{
+				count++;
+			});
+			stopwatch.stop();
+			doNotOptimize(count);
+		});
+	}
+
+	// picks the entities given a Velocity, a sparsity share of them.
+	std::vector<bool> pickMatchingEntities(size_t entityCount, double sparsity, size_t& outMatchingCount)
+	{
+		std::mt19937 random(RANDOM_SEED);
+		std::uniform_real_distribution<double> distribution(0.0, 1.0);
+		std::vector<bool> isMatching(entityCount);
+		outMatchingCount = 0;
+		for (size_t i = 0; i < entityCount; ++i)
+		{
+			isMatching[i] = distribution(random) < sparsity;
+			outMatchingCount += isMatching[i] ? 1 : 0;
+		}
+		return isMatching;
+	}
+
+	// fills a registry where every entity has a Position and the picked ones have a Velocity.
+	void createSparseRegistry(ECS::Registry& registry, const std::vector<bool>& isMatching)
+	{
+		std::vector<ECS::EntityId> entityIds;
+		registry.createMany(isMatching.size(), entityIds);
+		registry.emplaceMany<Position>(entityIds);
+		for (size_t i = 0; i < entityIds.size(); ++i)
+		{
+			if (isMatching[i])
+			{
+				registry.add<Velocity>(entityIds[i]);
+			}
+		}
+	}
+
+	void runIterationBenchmarks(BenchmarkRunner& runner, size_t entityCount)
+	{
+		runViewComponentCountBenchmark<Position>(runner, entityCount);
+		runViewComponentCountBenchmark<Position, Velocity>(runner, entityCount);
+		runViewComponentCountBenchmark<Position, Velocity, Health>(runner, entityCount);
+		runViewComponentCountBenchmark<Position, Velocity, Health, Armor>(runner, entityCount);
+
+		// the operations are the visited entities, the view still walks every entity of the registry.
+		for (const double sparsity : { 1.0, 0.5, 0.1, 0.01 })
+		{
+			size_t matchingCount = 0;
+			const std::vector<bool> isMatching = pickMatchingEntities(entityCount, sparsity, matchingCount);
+
+			runner.run("ViewEachSparsity", formatParameter("sparsity", sparsity), entityCount, matchingCount, [&isMatching](Stopwatch& stopwatch)
+			{
+				ECS::Registry registry;
+				createSparseRegistry(registry, isMatching);
+
+				ECS::View<Position, Velocity> view(registry);
+				stopwatch.start();
+				view.each([](ECS::EntityId, Position& position, Velocity& velocity)
+				{
+					position.x += velocity.x;
+				});
+				stopwatch.stop();
+			});
+
+			runner.run("QueryEachSparsity", formatParameter("sparsity", sparsity), entityCount, matchingCount, [&isMatching](Stopwatch& stopwatch)
+			{
+				ECS::Registry registry;
+				createSparseRegistry(registry, isMatching);
+
+				ECS::Query<Position, Velocity> query(registry);
+				stopwatch.start();
+				query.each([](ECS::EntityId, Position& position, Velocity& velocity)
+				{
+					position.x += velocity.x;
+				});
+				stopwatch.stop();
+			});
+		}
+
+		runner.run("SparseSetViewEach", "", entityCount, entityCount / 10, [entityCount](Stopwatch& stopwatch)
+		{
+			ECS::Registry registry;
+			std::vector<ECS::EntityId> entityIds;
+			registry.createMany(entityCount, entityIds);
+			registry.emplaceMany<Position>(entityIds);
+			for (size_t i = 0; i < entityIds.size(); i += 10)
+			{
+				registry.add<SparseComponent>(entityIds[i]);
+			}
+
+			ECS::View<SparseComponent, Position> view(registry);
+			stopwatch.start();
+			view.each([](ECS::EntityId, SparseComponent& sparseComponent, Position& position)
+			{
+				sparseComponent.value += position.x;
+			});
+			stopwatch.stop();
+		});
+	}
+
+	// iteration end
+
+	// parallel each begin
+
+	// compares each and parallelEach doing the same work, at fixed sizes so the crossover point shows whatever --entities is.
+	// parallelEach runs on a long lived worker pool, the threads are not started by the measured calls.
+	void runParallelEachBenchmarks(BenchmarkRunner& runner)
+	{
+		const size_t threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+		WorkerPool workerPool(threadCount - 1);
+
+		auto integrate = [](ECS::EntityId, Position& position, const Velocity& velocity)
+		{
+			position.x += velocity.x;
+			position.y += velocity.y;
+			position.z += velocity.z;
+		};
+
+		auto createRegistry = [](ECS::Registry& registry, size_t entityCount)
+		{
+			std::vector<ECS::EntityId> entityIds;
+			registry.createMany(entityCount, entityIds);
+			registry.emplaceMany<Position, Velocity>(entityIds);
+		};
+
+		for (const size_t entityCount : { 10'000, 100'000, 1'000'000 })
+		{
+			runner.run("ParallelEachSerial", formatParameter("threads", 1.0), entityCount, entityCount, [entityCount, &integrate, &createRegistry](Stopwatch& stopwatch)
+			{
+				ECS::Registry registry;
+				createRegistry(registry, entityCount);
+
+				ECS::View<Position, Velocity> view(registry);
+				stopwatch.start();
+				view.each(integrate);
+				stopwatch.stop();
+			});
+
+			ECS::setParallelFor([&workerPool](size_t batchCount, const std::function<void(size_t)>& function)
+			{
+				workerPool.parallelFor(batchCount, function);
+			});
+			runner.run("ParallelEachPooled", formatParameter("threads", static_cast<double>(threadCount)), entityCount, entityCount, [entityCount, &integrate, &createRegistry](Stopwatch& stopwatch)
+			{
+				ECS::Registry registry;
+				createRegistry(registry, entityCount);
+
+				ECS::View<Position, Velocity> view(registry);
+				stopwatch.start();
+				view.parallelEach(integrate);
+				stopwatch.stop();
+			});
+			ECS::setParallelFor(nullptr);
+		}
+	}
+
+	// parallel each end
+
+	// churn begin
+
+	// destroys and recreates a tenth of the entities each round, ids are recycled and views walk the holes.
+	void runChurnBenchmarks(BenchmarkRunner& runner, size_t entityCount)
+	{
+		const size_t roundCount = 10;
+		const size_t churnCount = entityCount / 10;
+		const std::string parameters = formatParameter("rounds", static_cast<double>(roundCount));
+
+		runner.run("RecycledIdChurn", parameters, entityCount, roundCount * churnCount * 2, [entityCount, roundCount, churnCount](Stopwatch& stopwatch)
+		{
+			ECS::Registry registry;
+			std::vector<ECS::EntityId> entityIds;
+			registry.createMany(entityCount, entityIds);
+			registry.emplaceMany<Position, Velocity>(entityIds);
+
+			std::mt19937 random(RANDOM_SEED);
+			stopwatch.start();
+			for (size_t round = 0; round < roundCount; ++round)
+			{
+				for (size_t i = 0; i < churnCount; ++i)
+				{
+					std::uniform_int_distribution<size_t> distribution(i, entityIds.size() - 1);
+					std::swap(entityIds[i], entityIds[distribution(random)]);
+					registry.destroy(entityIds[i]);
+				}
+
+				for (size_t i = 0; i < churnCount; ++i)
+				{
+					entityIds[i] = registry.create();
+					registry.add<Position>(entityIds[i]);
+					registry.add<Velocity>(entityIds[i]);
+				}
+			}
+			stopwatch.stop();
+			doNotOptimize(registry.size());
+		});
+
+		runner.run("ViewEachAfterChurn", "", entityCount, entityCount / 2, [entityCount](Stopwatch& stopwatch)
+		{
+			// half of the entities are destroyed, scattered over the indices.
+			ECS::Registry registry;
+			std::vector<ECS::EntityId> entityIds;
+			registry.createMany(entityCount, entityIds);
+			registry.emplaceMany<Position, Velocity>(entityIds);
+			std::shuffle(entityIds.begin(), entityIds.end(), std::mt19937(RANDOM_SEED));
+			registry.destroyMany(std::span<const ECS::EntityId>(entityIds.data(), entityIds.size() / 2));
+
+			ECS::View<Position, Velocity> view(registry);
+			stopwatch.start();
+			view.each([](ECS::EntityId, Position& position, Velocity& velocity)
+			{
+				position.x += velocity.x;
+			});
+			stopwatch.stop();
+		});
+
+		runner.run("Compact", "", entityCount, entityCount / 2, [entityCount](Stopwatch& stopwatch)
+		{
+			ECS::Registry registry;
+			std::vector<ECS::EntityId> entityIds;
+			registry.createMany(entityCount, entityIds);
+			registry.emplaceMany<Position, Velocity>(entityIds);
+			std::shuffle(entityIds.begin(), entityIds.end(), std::mt19937(RANDOM_SEED));
+			registry.destroyMany(std::span<const ECS::EntityId>(entityIds.data(), entityIds.size() / 2));
+
+			std::vector<ECS::EntityRemap> remaps;
+			stopwatch.start();
+			registry.compact(remaps);
+			stopwatch.stop();
+			doNotOptimize(remaps.size());
+		});
+	}
+
+	// churn end
+
+	void printUsage()
+	{
+		std::cerr << "ECSBenchmarks [--format=json|csv] [--output=<path>] [--filter=<name>] [--entities=<count>] [--repetitions=<count>]\n";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string format = "json";
+	std::string outputPath;
+	std::string filter;
+	size_t entityCount = 1'000'000;
+	size_t repetitionCount = 5;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view argument(argv[i]);
+		auto readValue = [&argument](std::string_view option, std::string& outValue)
+		{
+			if (argument.rfind(option, 0) != 0)
+			{
+				return false;
+			}
+			outValue = argument.substr(option.size());
+			return true;
+		};
+
+		std::string value;
+		if (readValue("--format=", format) || readValue("--output=", outputPath) || readValue("--filter=", filter))
+		{
+			continue;
+		}
+		if (readValue("--entities=", value))
+		{
+			entityCount = std::stoull(value);
+			continue;
+		}
+		if (readValue("--repetitions=", value))
+		{
+			repetitionCount = std::stoull(value);
+			continue;
+		}
+
+		printUsage();
+		return argument == "--help" ? 0 : 1;
+	}
+
+	if (format != "json" && format != "csv")
+	{
+		printUsage();
+		return 1;
+	}
+
+	BenchmarkRunner runner(repetitionCount, filter);
+	runCreateDestroyBenchmarks(runner, entityCount);
+	runComponentAccessBenchmarks<Position>(runner, "indexed", entityCount);
+	runComponentAccessBenchmarks<SparseComponent>(runner, "sparseset", entityCount);
+	runIterationBenchmarks(runner, entityCount);
+	runParallelEachBenchmarks(runner);
+	runChurnBenchmarks(runner, entityCount);
+
+	std::ofstream file;
+	if (!outputPath.empty())
+	{
+		file.open(outputPath);
+		if (!file.is_open())
+		{
+			std::cerr << "Could not open " << outputPath << "\n";
+			return 1;
+		}
+	}
+
+	std::ostream& stream = file.is_open() ? file : std::cout;
+	if (format == "csv")
+	{
+		runner.writeCsv(stream);
+	}
+	else
+	{
+		runner.writeJson(stream);
+	}
+	return 0;
+}
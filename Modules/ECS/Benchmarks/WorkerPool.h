@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Mani
+{
+	namespace Benchmarks
+	{
+		/*
+		 * Long lived worker threads running the batches of a parallel for. Benchmarks plug it in ECS::setParallelFor
+		 * so parallelEach is measured without starting threads on each call.
+		 */
+		class WorkerPool
+		{
+		public:
+			explicit WorkerPool(size_t workerCount)
+			{
+				m_threads.reserve(workerCount);
+				for (size_t i = 0; i < workerCount; ++i)
+				{
+					m_threads.emplace_back([this]() { work(); });
+				}
+			}
+
+			WorkerPool(const WorkerPool&) = delete;
+			WorkerPool& operator=(const WorkerPool&) = delete;
+
+			~WorkerPool()
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_isStopping = true;
+				}
+				m_wakeUp.notify_all();
+
+				for (std::thread& thread : m_threads)
+				{
+					thread.join();
+				}
+			}
+
+			// calls function(batchIndex) for each batch in [0, batchCount) on the workers and the calling thread,
+			// returns once every batch is done. Calls are expected to come from a single thread.
+			void parallelFor(size_t batchCount, const std::function<void(size_t)>& function)
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_function = &function;
+					m_batchCount = batchCount;
+					m_nextBatchIndex = 0;
+					m_busyWorkerCount = m_threads.size();
+					m_dispatchCount++;
+				}
+				m_wakeUp.notify_all();
+
+				runBatches(function, batchCount);
+
+				// every worker has to be done with the dispatch before function goes out of scope.
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_done.wait(lock, [this]() { return m_busyWorkerCount == 0; });
+			}
+
+		private:
+			std::vector<std::thread> m_threads;
+			std::mutex m_mutex;
+			std::condition_variable m_wakeUp;
+			std::condition_variable m_done;
+			const std::function<void(size_t)>* m_function = nullptr;
+			size_t m_batchCount = 0;
+			std::atomic<size_t> m_nextBatchIndex = 0;
+			size_t m_busyWorkerCount = 0;
+			// bumped by each parallelFor, a worker runs each dispatch once.
+			uint64_t m_dispatchCount = 0;
+			bool m_isStopping = false;
+
+			void runBatches(const std::function<void(size_t)>& function, size_t batchCount)
+			{
+				for (size_t batchIndex = m_nextBatchIndex++; batchIndex < batchCount; batchIndex = m_nextBatchIndex++)
+				{
+					function(batchIndex);
+				}
+			}
+
+			void work()
+			{
+				uint64_t lastDispatchCount = 0;
+				std::unique_lock<std::mutex> lock(m_mutex);
+				while (true)
+				{
+					m_wakeUp.wait(lock, [this, lastDispatchCount]() { return m_isStopping || m_dispatchCount != lastDispatchCount; });
+					if (m_isStopping)
+					{
+						return;
+					}
+
+					lastDispatchCount = m_dispatchCount;
+					const std::function<void(size_t)>& function = *m_function;
+					const size_t batchCount = m_batchCount;
+					lock.unlock();
+
+					runBatches(function, batchCount);
+
+					lock.lock();
+					if (--m_busyWorkerCount == 0)
+					{
+						m_done.notify_one();
+					}
+				}
+			}
+		};
+	}
+}
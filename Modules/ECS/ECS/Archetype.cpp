@@ -0,0 +1,81 @@
+#include "Archetype.h"
+
+using namespace Mani;
+
+ECS::Archetype::Archetype(const Bitset<MAX_COMPONENTS>& inSignature)
+	: m_signature(inSignature)
+{
+}
+
+ECS::Archetype::~Archetype()
+{
+	for (Chunk* chunk : m_chunks)
+	{
+		delete chunk;
+	}
+	m_chunks.clear();
+}
+
+size_t ECS::Archetype::add(ECS::EntityId entityId)
+{
+	const size_t row = m_size;
+	if (row / ARCHETYPE_CHUNK_SIZE >= m_chunks.size())
+	{
+		m_chunks.push_back(new Chunk());
+	}
+
+	(*m_chunks[row / ARCHETYPE_CHUNK_SIZE])[row % ARCHETYPE_CHUNK_SIZE] = entityId;
+	m_size++;
+	return row;
+}
+
+ECS::EntityId ECS::Archetype::remove(size_t row)
+{
+	if (row >= m_size)
+	{
+		return ECS::INVALID_ID;
+	}
+
+	const size_t lastRow = m_size - 1;
+	ECS::EntityId movedEntityId = ECS::INVALID_ID;
+	if (row != lastRow)
+	{
+		movedEntityId = at(lastRow);
+		(*m_chunks[row / ARCHETYPE_CHUNK_SIZE])[row % ARCHETYPE_CHUNK_SIZE] = movedEntityId;
+	}
+	m_size--;
+
+	// keep one spare chunk around so an entity going back and forth does not reallocate.
+	const size_t usedChunkCount = (m_size + ARCHETYPE_CHUNK_SIZE - 1) / ARCHETYPE_CHUNK_SIZE;
+	while (m_chunks.size() > usedChunkCount + 1)
+	{
+		delete m_chunks.back();
+		m_chunks.pop_back();
+	}
+
+	return movedEntityId;
+}
+
+bool ECS::Archetype::hasComponents(const Bitset<MAX_COMPONENTS>& componentMask) const
+{
+	return m_signature.contains(componentMask);
+}
+
+const Bitset<ECS::MAX_COMPONENTS>& ECS::Archetype::getSignature() const
+{
+	return m_signature;
+}
+
+ECS::Archetype::Edge& ECS::Archetype::getEdge(ComponentId componentId)
+{
+	if (componentId >= m_edges.size())
+	{
+		m_edges.resize(componentId + 1);
+	}
+	return m_edges[componentId];
+}
+
+void ECS::Archetype::addQuery(QueryState* queryState)
+{
+	m_queries.push_back(queryState);
+}
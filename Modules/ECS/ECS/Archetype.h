@@ -0,0 +1,93 @@
+#pragma once
+
+#include "ECS.h"
+#include "Entity.h"
+#include "Bitset.h"
+#include <array>
+#include <vector>
+
+namespace Mani
+{
+	namespace ECS
+	{
+		class QueryState;
+
+		// amount of entity ids packed in a single archetype chunk.
+		const size_t ARCHETYPE_CHUNK_SIZE = 1024;
+
+		/*
+		 * Groups all the entities sharing the same component signature.
+		 * Entity ids are packed in fixed-size chunks so a View only walks the entities it matches.
+		 */
+		class Archetype
+		{
+		public:
+			// cached transitions to the archetypes with one more or one less component.
+			struct Edge
+			{
+				Archetype* add = nullptr;
+				Archetype* remove = nullptr;
+			};
+
+			Archetype(const Bitset<MAX_COMPONENTS>& inSignature);
+			~Archetype();
+
+			// appends an entity to the archetype
+			// returns the row the entity was stored at
+			size_t add(ECS::EntityId entityId);
+
+			// removes the entity at row, the last entity of the archetype takes its place.
+			// returns the id of the entity that was moved to row, INVALID_ID if none was moved.
+			ECS::EntityId remove(size_t row);
+
+			// returns the entity id stored at row
+			ECS::EntityId at(size_t row) const;
+
+			// overwrites the entity id stored at row, used when an entity is renumbered.
+			void replace(size_t row, ECS::EntityId entityId);
+
+			// returns the amount of entities in the archetype
+			size_t size() const;
+
+			// returns true if the archetype's signature contains all the components in componentMask
+			bool hasComponents(const Bitset<MAX_COMPONENTS>& componentMask) const;
+
+			const Bitset<MAX_COMPONENTS>& getSignature() const;
+
+			Edge& getEdge(ComponentId componentId);
+
+			// persistent queries matching the archetype's signature, they follow the entities entering and leaving it.
+			void addQuery(QueryState* queryState);
+			const std::vector<QueryState*>& getQueries() const;
+
+		private:
+			using Chunk = std::array<ECS::EntityId, ARCHETYPE_CHUNK_SIZE>;
+
+			Bitset<MAX_COMPONENTS> m_signature;
+			std::vector<Chunk*> m_chunks;
+			std::vector<Edge> m_edges;
+			std::vector<QueryState*> m_queries;
+			size_t m_size = 0;
+		};
+
+		inline ECS::EntityId Archetype::at(size_t row) const
+		{
+			return (*m_chunks[row / ARCHETYPE_CHUNK_SIZE])[row % ARCHETYPE_CHUNK_SIZE];
+		}
+
+		inline void Archetype::replace(size_t row, ECS::EntityId entityId)
+		{
+			(*m_chunks[row / ARCHETYPE_CHUNK_SIZE])[row % ARCHETYPE_CHUNK_SIZE] = entityId;
+		}
+
+		inline size_t Archetype::size() const
+		{
+			return m_size;
+		}
+
+		inline const std::vector<QueryState*>& Archetype::getQueries() const
+		{
+			return m_queries;
+		}
+	}
+}
@@ -1,9 +1,14 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 
 namespace Mani
 {
+	/*
+	 * Fixed-size set of bits stored in 64 bits words.
+	 * Word loops have a compile time length, compilers unroll and vectorize them.
+	 */
 	template<unsigned int TBits>
 	requires (TBits > 0)
 	class Bitset
@@ -32,7 +37,7 @@ namespace Mani
 			{
 				return false;
 			}
-			return (m_bits[index / wordSize()] & (1 << index % wordSize())) > 0;
+			return (m_bits[index / wordSize()] & (uint64_t(1) << index % wordSize())) != 0;
 		};
 
 		Bitset& set(const unsigned int index, bool value = true)
@@ -43,8 +48,8 @@ namespace Mani
 			}
 
 			const unsigned int wordIndex = index / wordSize();
-			unsigned int& word = m_bits[wordIndex];
-			const unsigned int bit = 1 << index % wordSize();
+			uint64_t& word = m_bits[wordIndex];
+			const uint64_t bit = uint64_t(1) << index % wordSize();
 
 			if (value)
 			{
@@ -67,6 +72,28 @@ namespace Mani
 			return *this;
 		};
 
+		// returns true if every bit of mask is set, without building a temporary bitset.
+		bool contains(const Bitset& mask) const
+		{
+			uint64_t missingBits = 0;
+			for (unsigned int i = 0; i < wordCount(); ++i)
+			{
+				missingBits |= mask.m_bits[i] & ~m_bits[i];
+			}
+			return missingBits == 0;
+		};
+
+		// returns true if at least one bit is set in both bitsets.
+		bool intersects(const Bitset& other) const
+		{
+			uint64_t commonBits = 0;
+			for (unsigned int i = 0; i < wordCount(); ++i)
+			{
+				commonBits |= m_bits[i] & other.m_bits[i];
+			}
+			return commonBits != 0;
+		};
+
 		bool operator==(const Bitset& rhs) const
 		{
 			for (unsigned int i = 0; i < wordCount(); ++i)
@@ -107,9 +134,9 @@ namespace Mani
 		};
 
 	private:
-		constexpr unsigned int wordSize() const { return sizeof(unsigned int) * 8; };
-		constexpr unsigned int wordCount() const { return (TBits / wordSize()) + 1; };
-		std::array<unsigned int, (TBits / (sizeof(unsigned int) * 8)) + 1> m_bits;
+		static constexpr unsigned int wordSize() { return sizeof(uint64_t) * 8; };
+		static constexpr unsigned int wordCount() { return (TBits + wordSize() - 1) / wordSize(); };
+		std::array<uint64_t, (TBits + 63) / 64> m_bits;
 	};
 
 	template<unsigned int TBits>
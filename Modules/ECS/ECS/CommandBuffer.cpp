@@ -0,0 +1,175 @@
+#include "CommandBuffer.h"
+#include <algorithm>
+#include <assert.h>
+
+using namespace Mani;
+
+ECS::CommandBuffer::~CommandBuffer()
+{
+	discardCommands(m_commands);
+	m_commands.clear();
+
+	freeBlocks(m_blocks);
+	m_blocks.clear();
+}
+
+ECS::EntityId ECS::CommandBuffer::create()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// pending ids use the last generation, which no entity ever lives with.
+	assert(m_pendingEntityCount < ECS::ENTITY_INDEX_MASK);
+	const ECS::EntityId pendingEntityId = ECS::makeEntityId(m_pendingEntityCount++, ECS::MAX_ENTITY_GENERATION);
+
+	Command command;
+	command.type = ECommandType::Create;
+	command.entityId = pendingEntityId;
+	m_commands.push_back(command);
+	return pendingEntityId;
+}
+
+void ECS::CommandBuffer::destroy(ECS::EntityId entityId)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Command command;
+	command.type = ECommandType::Destroy;
+	command.entityId = entityId;
+	m_commands.push_back(command);
+}
+
+void ECS::CommandBuffer::flush(Registry& registry)
+{
+	// the commands are taken out of the buffer so the registry's events can record new ones.
+	std::vector<Command> commands;
+	std::vector<Block> blocks;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_commands.empty())
+		{
+			return;
+		}
+
+		commands.swap(m_commands);
+		blocks.swap(m_blocks);
+		m_blockIndex = 0;
+		m_blockOffset = 0;
+		m_pendingEntityCount = 0;
+	}
+
+	std::vector<ECS::EntityId> createdEntityIds;
+	auto resolve = [&createdEntityIds](ECS::EntityId entityId)
+	{
+		if (!isPending(entityId))
+		{
+			return entityId;
+		}
+
+		const ECS::EntityId pendingIndex = ECS::getEntityIndex(entityId);
+		return pendingIndex < createdEntityIds.size() ? createdEntityIds[pendingIndex] : ECS::INVALID_ID;
+	};
+
+	std::vector<ECS::EntityId> entityIds;
+	std::vector<void*> data;
+	size_t commandIndex = 0;
+	while (commandIndex < commands.size())
+	{
+		// consecutive commands of a kind, and of a component type, are applied in one go.
+		const Command& command = commands[commandIndex];
+		size_t endIndex = commandIndex + 1;
+		while (endIndex < commands.size() && commands[endIndex].type == command.type && commands[endIndex].apply == command.apply)
+		{
+			endIndex++;
+		}
+
+		entityIds.clear();
+		data.clear();
+		for (size_t i = commandIndex; i < endIndex; ++i)
+		{
+			entityIds.push_back(resolve(commands[i].entityId));
+			data.push_back(commands[i].data);
+		}
+
+		switch (command.type)
+		{
+			case ECommandType::Create:
+				registry.createMany(endIndex - commandIndex, createdEntityIds);
+				break;
+			case ECommandType::Destroy:
+				registry.destroyMany(entityIds);
+				break;
+			case ECommandType::Add:
+			case ECommandType::Remove:
+				command.apply(registry, entityIds, data);
+				break;
+		}
+		commandIndex = endIndex;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_blocks.empty())
+	{
+		// nothing was recorded during the flush, keep the blocks for the next commands.
+		m_blocks.swap(blocks);
+	}
+	freeBlocks(blocks);
+}
+
+bool ECS::CommandBuffer::isEmpty() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_commands.empty();
+}
+
+bool ECS::CommandBuffer::isPending(ECS::EntityId entityId)
+{
+	return entityId != ECS::INVALID_ID && ECS::getEntityGeneration(entityId) == ECS::MAX_ENTITY_GENERATION;
+}
+
+void* ECS::CommandBuffer::allocate(size_t size, size_t alignment)
+{
+	assert(alignment <= BLOCK_ALIGNMENT);
+
+	while (m_blockIndex < m_blocks.size())
+	{
+		const Block& block = m_blocks[m_blockIndex];
+		const size_t offset = (m_blockOffset + alignment - 1) / alignment * alignment;
+		if (offset + size <= block.size)
+		{
+			m_blockOffset = offset + size;
+			return block.memory + offset;
+		}
+
+		m_blockIndex++;
+		m_blockOffset = 0;
+	}
+
+	// components bigger than a block get a block of their own.
+	Block block;
+	block.size = std::max(BLOCK_SIZE, size);
+	block.memory = static_cast<unsigned char*>(::operator new[](block.size, std::align_val_t(BLOCK_ALIGNMENT)));
+	m_blocks.push_back(block);
+
+	m_blockIndex = m_blocks.size() - 1;
+	m_blockOffset = size;
+	return block.memory;
+}
+
+void ECS::CommandBuffer::discardCommands(const std::vector<Command>& commands)
+{
+	for (const Command& command : commands)
+	{
+		if (command.discard != nullptr)
+		{
+			command.discard(command.data);
+		}
+	}
+}
+
+void ECS::CommandBuffer::freeBlocks(const std::vector<Block>& blocks)
+{
+	for (const Block& block : blocks)
+	{
+		::operator delete[](block.memory, std::align_val_t(BLOCK_ALIGNMENT));
+	}
+}
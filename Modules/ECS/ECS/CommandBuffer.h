@@ -0,0 +1,167 @@
+#pragma once
+
+#include "ECS.h"
+#include "Entity.h"
+#include "Registry.h"
+#include <mutex>
+#include <new>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Mani
+{
+	namespace ECS
+	{
+		/*
+		 * Records structural changes to apply them to a Registry later, in a single flush.
+		 * Recording is thread safe: workers can spawn and destroy entities while views are iterated.
+		 * flush is expected to run on the thread owning the registry, at a sync point such as between tick groups.
+		 */
+		class CommandBuffer
+		{
+		public:
+			CommandBuffer() = default;
+			CommandBuffer(const CommandBuffer&) = delete;
+			CommandBuffer& operator=(const CommandBuffer&) = delete;
+			~CommandBuffer();
+
+			// records an entity creation
+			// returns a pending id, it can be used with this buffer's commands until the next flush.
+			ECS::EntityId create();
+
+			// records an entity destruction
+			void destroy(ECS::EntityId entityId);
+
+			// records the addition of component to an entity.
+			// the component is moved in the registry's storage when the buffer is flushed.
+			template<typename TComponent>
+			void add(ECS::EntityId entityId, TComponent component = TComponent());
+
+			// records the removal of an entity's TComponent
+			template<typename TComponent>
+			void remove(ECS::EntityId entityId);
+
+			// applies the recorded commands to registry, in the order they were recorded, then clears the buffer.
+			// consecutive creations, destructions and additions of a component type are applied in bulk, they broadcast the
+			// registry's bulk events instead of the per entity ones.
+			// commands recorded during the flush, e.g. from the registry's events, are kept for the next flush.
+			void flush(Registry& registry);
+
+			// returns true if no command is waiting to be flushed.
+			bool isEmpty() const;
+
+			// returns true if entityId was returned by a CommandBuffer and is not an actual entity yet.
+			static bool isPending(ECS::EntityId entityId);
+
+		private:
+			enum class ECommandType : uint8_t
+			{
+				Create,
+				Destroy,
+				Add,
+				Remove
+			};
+
+			struct Command
+			{
+				ECommandType type = ECommandType::Create;
+				ECS::EntityId entityId = ECS::INVALID_ID;
+				void* data = nullptr;
+				// applies consecutive Add or Remove commands of a component type to the registry, consumes their data.
+				void (*apply)(Registry& registry, std::span<const ECS::EntityId> entityIds, std::span<void* const> data) = nullptr;
+				// destroys the data of a command that was never applied.
+				void (*discard)(void* data) = nullptr;
+			};
+
+			struct Block
+			{
+				unsigned char* memory = nullptr;
+				size_t size = 0;
+			};
+
+			static constexpr size_t BLOCK_SIZE = 16 * 1024;
+			static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+			mutable std::mutex m_mutex;
+			std::vector<Command> m_commands;
+			// components are stored in blocks that never move, they are reused from a flush to the next.
+			std::vector<Block> m_blocks;
+			size_t m_blockIndex = 0;
+			size_t m_blockOffset = 0;
+			ECS::EntityId m_pendingEntityCount = 0;
+
+			// returns uninitialized memory for a recorded component. m_mutex is expected to be locked.
+			void* allocate(size_t size, size_t alignment);
+
+			static void discardCommands(const std::vector<Command>& commands);
+			static void freeBlocks(const std::vector<Block>& blocks);
+		};
+
+		template<typename TComponent>
+		inline void CommandBuffer::add(ECS::EntityId entityId, TComponent component)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			Command command;
+			command.type = ECommandType::Add;
+			command.entityId = entityId;
+			command.data = new (allocate(sizeof(TComponent), alignof(TComponent))) TComponent(std::move(component));
+			command.apply = [](Registry& registry, std::span<const ECS::EntityId> entityIds, std::span<void* const> data)
+			{
+				if constexpr (isTagComponent<TComponent>())
+				{
+					registry.emplaceMany<TComponent>(entityIds);
+				}
+				else
+				{
+					std::vector<bool> hadComponents(entityIds.size());
+					for (size_t i = 0; i < entityIds.size(); ++i)
+					{
+						hadComponents[i] = registry.has<TComponent>(entityIds[i]);
+					}
+
+					registry.emplaceMany<TComponent>(entityIds);
+
+					// walked backwards so an entity recorded twice ends up with its first component, as with Registry::add.
+					for (size_t i = entityIds.size(); i-- > 0;)
+					{
+						TComponent* component = hadComponents[i] ? nullptr : registry.get<TComponent>(entityIds[i]);
+						if (component != nullptr)
+						{
+							*component = std::move(*static_cast<TComponent*>(data[i]));
+						}
+					}
+				}
+
+				for (void* recordedComponent : data)
+				{
+					static_cast<TComponent*>(recordedComponent)->~TComponent();
+				}
+			};
+			command.discard = [](void* data)
+			{
+				static_cast<TComponent*>(data)->~TComponent();
+			};
+			m_commands.push_back(command);
+		}
+
+		template<typename TComponent>
+		inline void CommandBuffer::remove(ECS::EntityId entityId)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			Command command;
+			command.type = ECommandType::Remove;
+			command.entityId = entityId;
+			command.apply = [](Registry& registry, std::span<const ECS::EntityId> entityIds, std::span<void* const>)
+			{
+				for (const ECS::EntityId entityId : entityIds)
+				{
+					registry.remove<TComponent>(entityId);
+				}
+			};
+			m_commands.push_back(command);
+		}
+	}
+}
@@ -0,0 +1,457 @@
+#include "ComponentPool.h"
+#include "Snapshot.h"
+#include <algorithm>
+#include <assert.h>
+#include <cstring>
+
+using namespace Mani;
+
+// ComponentPool begin
+
+ECS::ComponentPool::ComponentPool(const ComponentInfo& inComponentInfo)
+	: m_componentInfo(inComponentInfo)
+{
+}
+
+ECS::ComponentPool::~ComponentPool()
+{
+	for (unsigned char* page : m_pages)
+	{
+		if (page != nullptr)
+		{
+			::operator delete[](page, std::align_val_t(m_componentInfo.alignment));
+		}
+	}
+	m_pages.clear();
+}
+
+void ECS::ComponentPool::reserve(size_t)
+{
+}
+
+void ECS::ComponentPool::renumber(ECS::EntityId entityId, ECS::EntityId newEntityId)
+{
+	// the occupancy follows the entity's index.
+	m_occupancy.reset(ECS::getEntityIndex(entityId));
+	m_occupancy.set(ECS::getEntityIndex(newEntityId));
+}
+
+void ECS::ComponentPool::shrink(size_t entityCount)
+{
+	m_occupancy.shrink(entityCount);
+}
+
+void ECS::ComponentPool::writeSnapshot(std::ostream& stream) const
+{
+	writeOccupancy(stream);
+}
+
+bool ECS::ComponentPool::readSnapshot(std::istream& stream, size_t entityCount)
+{
+	return readOccupancy(stream, entityCount);
+}
+
+void ECS::ComponentPool::writeOccupancy(std::ostream& stream) const
+{
+	const uint64_t wordCount = m_occupancy.wordCount();
+	writeSnapshotValue(stream, wordCount);
+	for (size_t wordIndex = 0; wordIndex < wordCount; ++wordIndex)
+	{
+		writeSnapshotValue(stream, m_occupancy.getWord(wordIndex));
+	}
+}
+
+bool ECS::ComponentPool::readOccupancy(std::istream& stream, size_t entityCount)
+{
+	uint64_t wordCount = 0;
+	if (!readSnapshotValue(stream, wordCount) || wordCount > (entityCount + EntityBitmap::WORD_SIZE - 1) / EntityBitmap::WORD_SIZE)
+	{
+		return false;
+	}
+
+	for (size_t wordIndex = 0; wordIndex < wordCount; ++wordIndex)
+	{
+		uint64_t word = 0;
+		if (!readSnapshotValue(stream, word))
+		{
+			return false;
+		}
+		m_occupancy.setWord(wordIndex, word);
+	}
+	return true;
+}
+
+void ECS::ComponentPool::markAdded(size_t entityIndex, uint32_t version)
+{
+	// tags have no data to change, their versions are not tracked.
+	if (m_componentInfo.storage == EComponentStorage::Tag)
+	{
+		return;
+	}
+
+	const size_t versionIndex = getVersionIndex(entityIndex);
+	if (versionIndex >= m_addedVersions.size())
+	{
+		m_addedVersions.resize(versionIndex + 1, 0);
+		m_changedVersions.resize(versionIndex + 1, 0);
+	}
+	m_addedVersions[versionIndex] = version;
+	m_changedVersions[versionIndex] = version;
+}
+
+void* ECS::ComponentPool::allocateSlot(size_t index)
+{
+	const size_t pageIndex = index / COMPONENT_PAGE_SIZE;
+	if (pageIndex >= m_pages.size())
+	{
+		// only the page table grows, existing pages stay where they are.
+		m_pages.resize(pageIndex + 1, nullptr);
+	}
+
+	if (m_pages[pageIndex] == nullptr)
+	{
+		const size_t pageSize = COMPONENT_PAGE_SIZE * m_componentInfo.size;
+		m_pages[pageIndex] = static_cast<unsigned char*>(::operator new[](pageSize, std::align_val_t(m_componentInfo.alignment)));
+	}
+
+	return getSlot(index);
+}
+
+void ECS::ComponentPool::releasePages(size_t pageCount)
+{
+	for (size_t pageIndex = pageCount; pageIndex < m_pages.size(); ++pageIndex)
+	{
+		if (m_pages[pageIndex] != nullptr)
+		{
+			::operator delete[](m_pages[pageIndex], std::align_val_t(m_componentInfo.alignment));
+		}
+	}
+	m_pages.resize(std::min(m_pages.size(), pageCount));
+	m_pages.shrink_to_fit();
+}
+
+// ComponentPool end
+
+// IndexedComponentPool begin
+
+ECS::IndexedComponentPool::IndexedComponentPool(const ComponentInfo& inComponentInfo)
+	: ComponentPool(inComponentInfo)
+{
+}
+
+ECS::IndexedComponentPool::~IndexedComponentPool()
+{
+	if (m_componentInfo.destroy == nullptr)
+	{
+		return;
+	}
+
+	// the components still in the pool belong to the entities alive when the registry is destroyed.
+	for (size_t wordIndex = 0; wordIndex < m_occupancy.wordCount(); ++wordIndex)
+	{
+		uint64_t word = m_occupancy.getWord(wordIndex);
+		while (word != 0)
+		{
+			const size_t bit = EntityBitmap::findFirstSetBit(word);
+			destroySlot(wordIndex * EntityBitmap::WORD_SIZE + bit);
+			word &= word - 1;
+		}
+	}
+}
+
+void* ECS::IndexedComponentPool::add(ECS::EntityId entityId)
+{
+	const ECS::EntityId entityIndex = ECS::getEntityIndex(entityId);
+	m_occupancy.set(entityIndex);
+	return allocateSlot(entityIndex);
+}
+
+void ECS::IndexedComponentPool::remove(ECS::EntityId entityId)
+{
+	// the slot is owned by the entity index, only the component is destroyed.
+	const ECS::EntityId entityIndex = ECS::getEntityIndex(entityId);
+	if (!m_occupancy.test(entityIndex))
+	{
+		return;
+	}
+
+	destroySlot(entityIndex);
+	m_occupancy.reset(entityIndex);
+}
+
+void ECS::IndexedComponentPool::renumber(ECS::EntityId entityId, ECS::EntityId newEntityId)
+{
+	// the component and its change versions follow the entity's index.
+	const ECS::EntityId entityIndex = ECS::getEntityIndex(entityId);
+	const ECS::EntityId newEntityIndex = ECS::getEntityIndex(newEntityId);
+	m_componentInfo.relocate(allocateSlot(newEntityIndex), getSlot(entityIndex));
+	markAdded(newEntityIndex, m_addedVersions[entityIndex]);
+	m_changedVersions[newEntityIndex] = m_changedVersions[entityIndex];
+	ComponentPool::renumber(entityId, newEntityId);
+}
+
+void ECS::IndexedComponentPool::shrink(size_t entityCount)
+{
+	ComponentPool::shrink(entityCount);
+	m_addedVersions.resize(std::min(m_addedVersions.size(), entityCount));
+	m_addedVersions.shrink_to_fit();
+	m_changedVersions.resize(std::min(m_changedVersions.size(), entityCount));
+	m_changedVersions.shrink_to_fit();
+	releasePages((entityCount + COMPONENT_PAGE_SIZE - 1) / COMPONENT_PAGE_SIZE);
+}
+
+void ECS::IndexedComponentPool::writeSnapshot(std::ostream& stream) const
+{
+	writeOccupancy(stream);
+
+	// the components are gathered in ascending index order and written as a single blob.
+	std::vector<unsigned char> blob;
+	for (size_t wordIndex = 0; wordIndex < m_occupancy.wordCount(); ++wordIndex)
+	{
+		uint64_t word = m_occupancy.getWord(wordIndex);
+		while (word != 0)
+		{
+			const size_t bit = EntityBitmap::findFirstSetBit(word);
+			const unsigned char* component = static_cast<const unsigned char*>(getSlot(wordIndex * EntityBitmap::WORD_SIZE + bit));
+			blob.insert(blob.end(), component, component + m_componentInfo.size);
+			word &= word - 1;
+		}
+	}
+	writeSnapshotBytes(stream, blob.data(), blob.size());
+}
+
+bool ECS::IndexedComponentPool::readSnapshot(std::istream& stream, size_t entityCount)
+{
+	if (!readOccupancy(stream, entityCount))
+	{
+		return false;
+	}
+
+	size_t componentCount = 0;
+	for (size_t wordIndex = 0; wordIndex < m_occupancy.wordCount(); ++wordIndex)
+	{
+		componentCount += std::popcount(m_occupancy.getWord(wordIndex));
+	}
+
+	std::vector<unsigned char> blob(componentCount * m_componentInfo.size);
+	if (!readSnapshotBytes(stream, blob.data(), blob.size()))
+	{
+		return false;
+	}
+
+	const unsigned char* component = blob.data();
+	for (size_t wordIndex = 0; wordIndex < m_occupancy.wordCount(); ++wordIndex)
+	{
+		uint64_t word = m_occupancy.getWord(wordIndex);
+		while (word != 0)
+		{
+			const size_t bit = EntityBitmap::findFirstSetBit(word);
+			std::memcpy(allocateSlot(wordIndex * EntityBitmap::WORD_SIZE + bit), component, m_componentInfo.size);
+			component += m_componentInfo.size;
+			word &= word - 1;
+		}
+	}
+	return true;
+}
+
+// IndexedComponentPool end
+
+// SparseSetComponentPool begin
+
+ECS::SparseSetComponentPool::SparseSetComponentPool(const ComponentInfo& inComponentInfo)
+	: ComponentPool(inComponentInfo)
+{
+}
+
+ECS::SparseSetComponentPool::~SparseSetComponentPool()
+{
+	for (size_t index = 0; index < m_entityIds.size(); ++index)
+	{
+		destroySlot(index);
+	}
+}
+
+void* ECS::SparseSetComponentPool::add(ECS::EntityId entityId)
+{
+	const ECS::EntityId entityIndex = ECS::getEntityIndex(entityId);
+	if (entityIndex >= m_sparse.size())
+	{
+		m_sparse.resize(entityIndex + 1, INVALID_INDEX);
+	}
+	assert(m_sparse[entityIndex] == INVALID_INDEX);
+
+	const size_t index = m_entityIds.size();
+	m_sparse[entityIndex] = index;
+	m_entityIds.push_back(entityId);
+	m_occupancy.set(entityIndex);
+	return allocateSlot(index);
+}
+
+void ECS::SparseSetComponentPool::remove(ECS::EntityId entityId)
+{
+	const ECS::EntityId entityIndex = ECS::getEntityIndex(entityId);
+	if (entityIndex >= m_sparse.size() || m_sparse[entityIndex] == INVALID_INDEX)
+	{
+		return;
+	}
+
+	// keep the array dense by moving the last component and its versions in the freed slot.
+	const size_t index = m_sparse[entityIndex];
+	const size_t lastIndex = m_entityIds.size() - 1;
+	destroySlot(index);
+	if (index != lastIndex)
+	{
+		m_componentInfo.relocate(getSlot(index), getSlot(lastIndex));
+
+		const ECS::EntityId movedEntityId = m_entityIds[lastIndex];
+		m_entityIds[index] = movedEntityId;
+		m_sparse[ECS::getEntityIndex(movedEntityId)] = index;
+		if (lastIndex < m_addedVersions.size())
+		{
+			m_addedVersions[index] = m_addedVersions[lastIndex];
+			m_changedVersions[index] = m_changedVersions[lastIndex];
+		}
+	}
+
+	m_entityIds.pop_back();
+	m_addedVersions.resize(std::min(m_addedVersions.size(), m_entityIds.size()));
+	m_changedVersions.resize(std::min(m_changedVersions.size(), m_entityIds.size()));
+	m_sparse[entityIndex] = INVALID_INDEX;
+	m_occupancy.reset(entityIndex);
+}
+
+void ECS::SparseSetComponentPool::reserve(size_t count)
+{
+	m_entityIds.reserve(m_entityIds.size() + count);
+}
+
+void ECS::SparseSetComponentPool::renumber(ECS::EntityId entityId, ECS::EntityId newEntityId)
+{
+	// the component and its versions stay where they are, only the entity owning them changes.
+	const ECS::EntityId entityIndex = ECS::getEntityIndex(entityId);
+	const ECS::EntityId newEntityIndex = ECS::getEntityIndex(newEntityId);
+	if (newEntityIndex >= m_sparse.size())
+	{
+		m_sparse.resize(newEntityIndex + 1, INVALID_INDEX);
+	}
+
+	const size_t index = m_sparse[entityIndex];
+	m_entityIds[index] = newEntityId;
+	m_sparse[newEntityIndex] = index;
+	m_sparse[entityIndex] = INVALID_INDEX;
+	ComponentPool::renumber(entityId, newEntityId);
+}
+
+void ECS::SparseSetComponentPool::shrink(size_t entityCount)
+{
+	ComponentPool::shrink(entityCount);
+	m_sparse.resize(std::min(m_sparse.size(), entityCount));
+	m_sparse.shrink_to_fit();
+	m_entityIds.shrink_to_fit();
+	m_addedVersions.shrink_to_fit();
+	m_changedVersions.shrink_to_fit();
+	releasePages((m_entityIds.size() + COMPONENT_PAGE_SIZE - 1) / COMPONENT_PAGE_SIZE);
+}
+
+void ECS::SparseSetComponentPool::writeSnapshot(std::ostream& stream) const
+{
+	writeOccupancy(stream);
+
+	const uint64_t componentCount = m_entityIds.size();
+	writeSnapshotValue(stream, componentCount);
+	for (const ECS::EntityId entityId : m_entityIds)
+	{
+		writeSnapshotValue(stream, static_cast<uint64_t>(entityId));
+	}
+
+	// components are dense, each page is written at once.
+	for (size_t index = 0; index < m_entityIds.size(); index += COMPONENT_PAGE_SIZE)
+	{
+		const size_t count = std::min(COMPONENT_PAGE_SIZE, m_entityIds.size() - index);
+		writeSnapshotBytes(stream, getSlot(index), count * m_componentInfo.size);
+	}
+}
+
+bool ECS::SparseSetComponentPool::readSnapshot(std::istream& stream, size_t entityCount)
+{
+	uint64_t componentCount = 0;
+	if (!readOccupancy(stream, entityCount) || !readSnapshotValue(stream, componentCount))
+	{
+		return false;
+	}
+
+	// one component per occupied index, a corrupt count must not drive the allocations.
+	size_t occupiedCount = 0;
+	for (size_t wordIndex = 0; wordIndex < m_occupancy.wordCount(); ++wordIndex)
+	{
+		occupiedCount += std::popcount(m_occupancy.getWord(wordIndex));
+	}
+	if (componentCount != occupiedCount)
+	{
+		return false;
+	}
+
+	m_entityIds.resize(componentCount);
+	for (size_t index = 0; index < componentCount; ++index)
+	{
+		uint64_t entityId = 0;
+		if (!readSnapshotValue(stream, entityId))
+		{
+			return false;
+		}
+
+		m_entityIds[index] = static_cast<ECS::EntityId>(entityId);
+		const ECS::EntityId entityIndex = ECS::getEntityIndex(m_entityIds[index]);
+		if (entityIndex >= entityCount || !m_occupancy.test(entityIndex))
+		{
+			return false;
+		}
+
+		if (entityIndex >= m_sparse.size())
+		{
+			m_sparse.resize(entityIndex + 1, INVALID_INDEX);
+		}
+		if (m_sparse[entityIndex] != INVALID_INDEX)
+		{
+			return false;
+		}
+		m_sparse[entityIndex] = index;
+	}
+
+	for (size_t index = 0; index < componentCount; index += COMPONENT_PAGE_SIZE)
+	{
+		const size_t count = std::min(COMPONENT_PAGE_SIZE, static_cast<size_t>(componentCount) - index);
+		if (!readSnapshotBytes(stream, allocateSlot(index), count * m_componentInfo.size))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// SparseSetComponentPool end
+
+// TagComponentPool begin
+
+ECS::TagComponentPool::TagComponentPool(const ComponentInfo& inComponentInfo)
+	: ComponentPool(inComponentInfo)
+{
+}
+
+void* ECS::TagComponentPool::add(ECS::EntityId entityId)
+{
+	m_occupancy.set(ECS::getEntityIndex(entityId));
+	return nullptr;
+}
+
+void* ECS::TagComponentPool::get(ECS::EntityId)
+{
+	return nullptr;
+}
+
+void ECS::TagComponentPool::remove(ECS::EntityId entityId)
+{
+	m_occupancy.reset(ECS::getEntityIndex(entityId));
+}
+
+// TagComponentPool end
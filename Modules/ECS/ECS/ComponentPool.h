@@ -0,0 +1,333 @@
+#pragma once
+
+#include "ECS.h"
+#include "Entity.h"
+#include "EntityBitmap.h"
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <new>
+#include <utility>
+#include <concepts>
+#include <type_traits>
+
+namespace Mani
+{
+	namespace ECS
+	{
+		// amount of components in a pool page. Pages are never moved nor reallocated once created.
+		const size_t COMPONENT_PAGE_SIZE = 1024;
+
+		enum class EComponentStorage : uint8_t
+		{
+			// one slot per entity index. Fastest access, best suited for components most entities have.
+			Indexed,
+			// a dense array of components and a sparse entity to index map. Memory scales with the amount of components.
+			SparseSet,
+			// empty components, only the occupancy bit of the entity is stored.
+			Tag
+		};
+
+		// empty components are tags: they have no storage, adding one only sets a bit.
+		template<typename TComponent>
+		constexpr bool isTagComponent()
+		{
+			return std::is_empty_v<TComponent>;
+		}
+
+		/*
+		 * Type erased description of a component type. It is used to create and manage the component's pool.
+		 */
+		struct ComponentInfo
+		{
+			size_t size = 0;
+			size_t alignment = 0;
+			EComponentStorage storage = EComponentStorage::Indexed;
+			// move constructs the component at source into destination, then destroys source.
+			void (*relocate)(void* destination, void* source) = nullptr;
+			// runs the component's destructor, nullptr for trivially destructible components.
+			void (*destroy)(void* component) = nullptr;
+			// trivially copyable components are saved in registry snapshots as raw bytes.
+			bool isTriviallyCopyable = false;
+		};
+
+		// Components are stored in an Indexed pool by default. A component opts into another storage by declaring:
+		// static constexpr ECS::EComponentStorage storage = ECS::EComponentStorage::SparseSet;
+		template<typename TComponent>
+		constexpr EComponentStorage getComponentStorage()
+		{
+			if constexpr (isTagComponent<TComponent>())
+			{
+				return EComponentStorage::Tag;
+			}
+			else if constexpr (requires { { TComponent::storage } -> std::convertible_to<EComponentStorage>; })
+			{
+				return TComponent::storage;
+			}
+			else
+			{
+				return EComponentStorage::Indexed;
+			}
+		}
+
+		template<typename TComponent>
+		const ComponentInfo& getComponentInfo()
+		{
+			static const ComponentInfo componentInfo = {
+				sizeof(TComponent),
+				alignof(TComponent),
+				getComponentStorage<TComponent>(),
+				[](void* destination, void* source)
+				{
+					TComponent* sourceComponent = static_cast<TComponent*>(source);
+					new (destination) TComponent(std::move(*sourceComponent));
+					sourceComponent->~TComponent();
+				},
+				std::is_trivially_destructible_v<TComponent> ? nullptr : static_cast<void (*)(void*)>([](void* component)
+				{
+					static_cast<TComponent*>(component)->~TComponent();
+				}),
+				std::is_trivially_copyable_v<TComponent>
+			};
+			return componentInfo;
+		}
+
+		/*
+		 * Holds the memory of all the components of a single type.
+		 * The memory is split in fixed-size pages allocated on demand: growing a pool never moves a component.
+		 */
+		class ComponentPool
+		{
+		public:
+			ComponentPool(const ComponentInfo& inComponentInfo);
+			virtual ~ComponentPool();
+
+			// returns the uninitialized storage for entityId's component
+			virtual void* add(ECS::EntityId entityId) = 0;
+
+			// returns entityId's component. The entity is expected to have the component.
+			virtual void* get(ECS::EntityId entityId) = 0;
+
+			// destroys entityId's component and releases its storage
+			virtual void remove(ECS::EntityId entityId) = 0;
+
+			// prepares the pool to receive count more components. Pages are still allocated on demand.
+			virtual void reserve(size_t count);
+
+			// moves entityId's component to newEntityId. The index of newEntityId is expected to be empty.
+			virtual void renumber(ECS::EntityId entityId, ECS::EntityId newEntityId);
+
+			// releases the memory held for the entity indices past entityCount, which are expected to be empty.
+			virtual void shrink(size_t entityCount);
+
+			// writes the pool's occupancy and components as raw bytes. The component type is expected to be trivially copyable.
+			virtual void writeSnapshot(std::ostream& stream) const;
+			// reads what writeSnapshot wrote into an empty pool, for a snapshot of entityCount entities.
+			// returns false if the stream is truncated or holds components past entityCount.
+			virtual bool readSnapshot(std::istream& stream, size_t entityCount);
+
+			EComponentStorage getStorage() const;
+
+			const ComponentInfo& getComponentInfo() const;
+
+			// one bit per entity index, set when the entity has a component in the pool.
+			const EntityBitmap& getOccupancy() const;
+
+			// stamps the component of the entity at entityIndex as added and changed at version. Tags are not stamped.
+			void markAdded(size_t entityIndex, uint32_t version);
+			// stamps the component of the entity at entityIndex as changed at version. Tags are not stamped.
+			void markChanged(size_t entityIndex, uint32_t version);
+
+			// returns the version the component of the entity at entityIndex was added at. The entity is expected to have the component.
+			uint32_t getAddedVersion(size_t entityIndex) const;
+			// returns the last version the component of the entity at entityIndex was changed at. The entity is expected to have the component.
+			uint32_t getChangedVersion(size_t entityIndex) const;
+
+			// returns the amount of version slots held by the pool.
+			size_t getVersionCount() const;
+
+		protected:
+			ComponentInfo m_componentInfo;
+			EntityBitmap m_occupancy;
+			// change versions, indexed like the components: by entity index, or in dense order for sparse sets.
+			std::vector<uint32_t> m_addedVersions;
+			std::vector<uint32_t> m_changedVersions;
+
+			// returns where the versions of the entity at entityIndex are stored.
+			size_t getVersionIndex(size_t entityIndex) const;
+
+			// returns the slot at index, allocating its page if needed.
+			void* allocateSlot(size_t index);
+			// returns the slot at index. Its page is expected to be allocated.
+			void* getSlot(size_t index) const;
+			// runs the destructor of the component at index, if it has one.
+			void destroySlot(size_t index);
+
+			// frees the pages past pageCount.
+			void releasePages(size_t pageCount);
+
+			void writeOccupancy(std::ostream& stream) const;
+			bool readOccupancy(std::istream& stream, size_t entityCount);
+
+		private:
+			std::vector<unsigned char*> m_pages;
+		};
+
+		inline EComponentStorage ComponentPool::getStorage() const
+		{
+			return m_componentInfo.storage;
+		}
+
+		inline const ComponentInfo& ComponentPool::getComponentInfo() const
+		{
+			return m_componentInfo;
+		}
+
+		inline const EntityBitmap& ComponentPool::getOccupancy() const
+		{
+			return m_occupancy;
+		}
+
+		inline size_t ComponentPool::getVersionCount() const
+		{
+			return m_addedVersions.size();
+		}
+
+		inline void* ComponentPool::getSlot(size_t index) const
+		{
+			return m_pages[index / COMPONENT_PAGE_SIZE] + (index % COMPONENT_PAGE_SIZE) * m_componentInfo.size;
+		}
+
+		/*
+		 * One slot per entity index, the component of an entity lives at its index.
+		 * Only the pages holding components are allocated.
+		 */
+		class IndexedComponentPool : public ComponentPool
+		{
+		public:
+			IndexedComponentPool(const ComponentInfo& inComponentInfo);
+			virtual ~IndexedComponentPool() override;
+
+			virtual void* add(ECS::EntityId entityId) override;
+			virtual void* get(ECS::EntityId entityId) override;
+			virtual void remove(ECS::EntityId entityId) override;
+			virtual void renumber(ECS::EntityId entityId, ECS::EntityId newEntityId) override;
+			virtual void shrink(size_t entityCount) override;
+			virtual void writeSnapshot(std::ostream& stream) const override;
+			virtual bool readSnapshot(std::istream& stream, size_t entityCount) override;
+		};
+
+		/*
+		 * Components are packed in a dense array, a sparse array maps an entity id to its component's index.
+		 * add, get and remove are O(1) and the memory only grows with the amount of components.
+		 * Removing a component moves the last component of the pool in the freed slot.
+		 */
+		class SparseSetComponentPool : public ComponentPool
+		{
+		public:
+			SparseSetComponentPool(const ComponentInfo& inComponentInfo);
+			virtual ~SparseSetComponentPool() override;
+
+			virtual void* add(ECS::EntityId entityId) override;
+			virtual void* get(ECS::EntityId entityId) override;
+			virtual void remove(ECS::EntityId entityId) override;
+			virtual void reserve(size_t count) override;
+			virtual void renumber(ECS::EntityId entityId, ECS::EntityId newEntityId) override;
+			virtual void shrink(size_t entityCount) override;
+			virtual void writeSnapshot(std::ostream& stream) const override;
+			virtual bool readSnapshot(std::istream& stream, size_t entityCount) override;
+
+			// returns the amount of components in the pool
+			size_t size() const;
+
+			// returns the entity owning the component at index
+			ECS::EntityId getEntityId(size_t index) const;
+
+			// returns the index of the component of the entity at entityIndex. The entity is expected to have the component.
+			size_t getDenseIndex(size_t entityIndex) const;
+
+		private:
+			static constexpr size_t INVALID_INDEX = SIZE_MAX;
+
+			std::vector<ECS::EntityId> m_entityIds;
+			std::vector<size_t> m_sparse;
+		};
+
+		/*
+		 * Holds tag components: only the occupancy bitmap is kept, no memory is allocated for the components.
+		 */
+		class TagComponentPool : public ComponentPool
+		{
+		public:
+			TagComponentPool(const ComponentInfo& inComponentInfo);
+
+			// tags have no storage, returns nullptr.
+			virtual void* add(ECS::EntityId entityId) override;
+			// tags have no storage, returns nullptr.
+			virtual void* get(ECS::EntityId entityId) override;
+			virtual void remove(ECS::EntityId entityId) override;
+		};
+
+		inline void ComponentPool::destroySlot(size_t index)
+		{
+			if (m_componentInfo.destroy != nullptr)
+			{
+				m_componentInfo.destroy(getSlot(index));
+			}
+		}
+
+		inline void* IndexedComponentPool::get(ECS::EntityId entityId)
+		{
+			return getSlot(ECS::getEntityIndex(entityId));
+		}
+
+		inline void* SparseSetComponentPool::get(ECS::EntityId entityId)
+		{
+			return getSlot(m_sparse[ECS::getEntityIndex(entityId)]);
+		}
+
+		inline size_t SparseSetComponentPool::size() const
+		{
+			return m_entityIds.size();
+		}
+
+		inline ECS::EntityId SparseSetComponentPool::getEntityId(size_t index) const
+		{
+			return m_entityIds[index];
+		}
+
+		inline size_t SparseSetComponentPool::getDenseIndex(size_t entityIndex) const
+		{
+			return m_sparse[entityIndex];
+		}
+
+		inline size_t ComponentPool::getVersionIndex(size_t entityIndex) const
+		{
+			// sparse sets keep the versions next to their components, their memory scales with the amount of components.
+			if (m_componentInfo.storage == EComponentStorage::SparseSet)
+			{
+				return static_cast<const SparseSetComponentPool*>(this)->getDenseIndex(entityIndex);
+			}
+			return entityIndex;
+		}
+
+		inline void ComponentPool::markChanged(size_t entityIndex, uint32_t version)
+		{
+			if (m_componentInfo.storage == EComponentStorage::Tag)
+			{
+				return;
+			}
+			m_changedVersions[getVersionIndex(entityIndex)] = version;
+		}
+
+		inline uint32_t ComponentPool::getAddedVersion(size_t entityIndex) const
+		{
+			return m_addedVersions[getVersionIndex(entityIndex)];
+		}
+
+		inline uint32_t ComponentPool::getChangedVersion(size_t entityIndex) const
+		{
+			return m_changedVersions[getVersionIndex(entityIndex)];
+		}
+	}
+}
@@ -0,0 +1,109 @@
+#include "ComponentType.h"
+#include <assert.h>
+
+using namespace Mani;
+
+ECS::ComponentTypeRegistry& ECS::ComponentTypeRegistry::get()
+{
+	static ComponentTypeRegistry componentTypeRegistry;
+	return componentTypeRegistry;
+}
+
+namespace
+{
+	bool hasSameLayout(const ECS::ComponentInfo& lhs, const ECS::ComponentInfo& rhs)
+	{
+		return lhs.size == rhs.size && lhs.alignment == rhs.alignment && lhs.storage == rhs.storage;
+	}
+}
+
+ECS::ComponentId ECS::ComponentTypeRegistry::getComponentId(const ComponentInfo& componentInfo, std::string_view typeName)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (auto it = m_componentIds.find(&componentInfo); it != m_componentIds.end())
+	{
+		return it->second;
+	}
+	return addComponentType(typeName, &componentInfo);
+}
+
+ECS::ComponentId ECS::ComponentTypeRegistry::getComponentId(std::string_view typeName, const ComponentInfo* componentInfo)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (componentInfo != nullptr)
+	{
+		if (auto it = m_componentIds.find(componentInfo); it != m_componentIds.end())
+		{
+			return it->second;
+		}
+	}
+
+	for (ComponentId componentId = 0; componentId < m_componentNames.size(); ++componentId)
+	{
+		if (m_componentNames[componentId] != typeName)
+		{
+			continue;
+		}
+
+		const ComponentInfo* knownComponentInfo = m_componentInfos[componentId];
+		if (componentInfo == nullptr || knownComponentInfo == nullptr || hasSameLayout(*knownComponentInfo, *componentInfo))
+		{
+			if (componentInfo != nullptr)
+			{
+				m_componentIds[componentInfo] = componentId;
+				if (knownComponentInfo == nullptr)
+				{
+					m_componentInfos[componentId] = componentInfo;
+				}
+			}
+			return componentId;
+		}
+
+		// sharing a pool between different layouts would corrupt the components.
+		assert(false && "Two component types share a name but not their layout.");
+	}
+
+	return addComponentType(typeName, componentInfo);
+}
+
+ECS::ComponentId ECS::ComponentTypeRegistry::addComponentType(std::string_view typeName, const ComponentInfo* componentInfo)
+{
+	const ComponentId componentId = static_cast<ComponentId>(m_componentNames.size());
+	assert(componentId < MAX_COMPONENTS);
+	if (componentInfo != nullptr)
+	{
+		m_componentIds[componentInfo] = componentId;
+	}
+	m_componentNames.emplace_back(typeName);
+	m_componentInfos.push_back(componentInfo);
+	return componentId;
+}
+
+bool ECS::ComponentTypeRegistry::findComponentId(std::string_view typeName, ComponentId& outComponentId)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (ComponentId componentId = 0; componentId < m_componentNames.size(); ++componentId)
+	{
+		if (m_componentNames[componentId] == typeName)
+		{
+			outComponentId = componentId;
+			return true;
+		}
+	}
+	return false;
+}
+
+std::string ECS::ComponentTypeRegistry::getComponentName(ComponentId componentId)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return componentId < m_componentNames.size() ? m_componentNames[componentId] : std::string();
+}
+
+const ECS::ComponentInfo* ECS::ComponentTypeRegistry::getComponentInfo(ComponentId componentId)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return componentId < m_componentInfos.size() ? m_componentInfos[componentId] : nullptr;
+}
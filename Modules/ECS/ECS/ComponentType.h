@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ECS.h"
+#include "Entity.h"
+#include "ComponentPool.h"
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace Mani
+{
+	namespace ECS
+	{
+		/*
+		 * Assigns a dense ComponentId to each component type. Types are told apart by their ComponentInfo, which is unique
+		 * per type within a module, and matched by name across modules.
+		 * There is one ComponentTypeRegistry per module linking the ECS library.
+		 */
+		class ComponentTypeRegistry
+		{
+		public:
+			static ComponentTypeRegistry& get();
+
+			// returns the id of the type described by componentInfo, assigns the next id if it was never seen.
+			// types sharing a name, e.g. in anonymous namespaces of different translation units, get different ids.
+			ComponentId getComponentId(const ComponentInfo& componentInfo, std::string_view typeName);
+
+			// returns the id of the type named typeName, used for the types of another module. Assigns the next id if typeName was never seen.
+			// asserts if the named type has another size, alignment or storage than componentInfo.
+			// componentInfo is kept to rebuild the component's pool from a snapshot.
+			ComponentId getComponentId(std::string_view typeName, const ComponentInfo* componentInfo = nullptr);
+
+			// returns false if typeName was never seen. Unlike getComponentId, no id is assigned.
+			// if several types share the name, returns the first one.
+			bool findComponentId(std::string_view typeName, ComponentId& outComponentId);
+
+			// returns the name of a component type, empty if componentId was never assigned.
+			std::string getComponentName(ComponentId componentId);
+
+			// returns the description of a component type, nullptr if it was never given.
+			const ComponentInfo* getComponentInfo(ComponentId componentId);
+
+		private:
+			std::mutex m_mutex;
+			std::unordered_map<const ComponentInfo*, ComponentId> m_componentIds;
+			std::vector<std::string> m_componentNames;
+			std::vector<const ComponentInfo*> m_componentInfos;
+
+			ComponentId addComponentType(std::string_view typeName, const ComponentInfo* componentInfo);
+		};
+
+		// returns TComponent's id in this module's ComponentTypeRegistry.
+		// the id is resolved once, next calls do not hash.
+		template<typename TComponent>
+		ComponentId getComponentTypeId()
+		{
+			static const ComponentId componentId = ComponentTypeRegistry::get().getComponentId(getComponentInfo<TComponent>(), typeid(TComponent).name());
+			return componentId;
+		}
+	}
+}
@@ -21,7 +21,7 @@ bool ECS::Entity::hasComponent(ComponentId componentId) const
 
 bool ECS::Entity::hasComponents(const Bitset<MAX_COMPONENTS>& componentMask) const
 {
-	return componentMask == (componentMask & m_components);
+	return m_components.contains(componentMask);
 }
 
 void ECS::Entity::setComponentBit(ComponentId componentId)
@@ -38,3 +38,8 @@ void ECS::Entity::resetComponentBits()
 {
 	m_components.reset();
 }
+
+const Bitset<ECS::MAX_COMPONENTS>& ECS::Entity::getSignature() const
+{
+	return m_components;
+}
@@ -2,26 +2,64 @@
 
 #include "ECS.h"
 #include "Bitset.h"
+#include <cstddef>
 #include <cstdint>
 
 namespace Mani 
 {
 	namespace ECS
 	{
-		const int MAX_COMPONENTS = 64;
+#ifndef MANI_MAX_COMPONENTS
+#define MANI_MAX_COMPONENTS 128
+#endif
+		// amount of component types an application can register. Define MANI_MAX_COMPONENTS to raise it, signatures grow by 64 bits words.
+		const unsigned int MAX_COMPONENTS = MANI_MAX_COMPONENTS;
 
+		/*
+		 * An EntityId packs the entity's index in its low bits and a generation in its high bits.
+		 * The generation is bumped each time an index is recycled, ids of destroyed entities never become valid again.
+		 */
 #if MANI_WEBGL
 		using EntityId = unsigned int;
 		const EntityId INVALID_ID = UINT32_MAX;
+		const EntityId ENTITY_INDEX_BITS = 20;
 #else
 		using EntityId = size_t;
 		const EntityId INVALID_ID = UINT64_MAX;
+		const EntityId ENTITY_INDEX_BITS = 32;
 #endif
+		const EntityId ENTITY_INDEX_MASK = (EntityId(1) << ENTITY_INDEX_BITS) - 1;
+		// an index reaching this generation is not recycled anymore.
+		const EntityId MAX_ENTITY_GENERATION = INVALID_ID >> ENTITY_INDEX_BITS;
 
 		using ComponentId = unsigned int;
+		const ComponentId INVALID_COMPONENT_ID = UINT32_MAX;
 
 		bool isValid(EntityId entityId);
 
+		inline EntityId makeEntityId(EntityId index, EntityId generation)
+		{
+			return (generation << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+		}
+
+		// returns the slot of the entity in the registry's storage.
+		inline EntityId getEntityIndex(EntityId entityId)
+		{
+			return entityId & ENTITY_INDEX_MASK;
+		}
+
+		inline EntityId getEntityGeneration(EntityId entityId)
+		{
+			return entityId >> ENTITY_INDEX_BITS;
+		}
+
+		// an entity renumbered by a registry compaction.
+		struct EntityRemap
+		{
+			EntityId oldId = INVALID_ID;
+			EntityId newId = INVALID_ID;
+		};
+
 		/*
 		 * An entity. It knows about its id and the components it has.
 		 */
@@ -30,10 +68,11 @@ namespace Mani
 		public:
 			Entity() = default;
 			Entity(const Entity& other);
+			Entity& operator=(const Entity& other) = default;
 			
+			// the id of the entity's current life, its generation is bumped when the entity is destroyed.
 			EntityId id = ECS::INVALID_ID;
 
-			// todo #2: this is kinda messed up. This means that when an entity is reused it will have the same id as in its previous life.
 			bool isAlive = false;
 
 			bool hasComponent(ComponentId componentId) const;
@@ -41,6 +80,7 @@ namespace Mani
 			void setComponentBit(ComponentId componentId);
 			void resetComponentBit(ComponentId componentId);
 			void resetComponentBits();
+			const Bitset<MAX_COMPONENTS>& getSignature() const;
 
 		private:
 			Bitset<MAX_COMPONENTS> m_components;
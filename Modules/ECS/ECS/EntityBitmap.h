@@ -0,0 +1,85 @@
+#pragma once
+
+#include "ECS.h"
+#include "Entity.h"
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace Mani
+{
+	namespace ECS
+	{
+		/*
+		 * One bit per entity index, packed in 64 bits words.
+		 * Views AND the words of several bitmaps and jump from a set bit to the next one, skipping empty regions a word at a time.
+		 */
+		class EntityBitmap
+		{
+		public:
+			static constexpr size_t WORD_SIZE = 64;
+
+			void set(ECS::EntityId entityIndex)
+			{
+				const size_t wordIndex = entityIndex / WORD_SIZE;
+				if (wordIndex >= m_words.size())
+				{
+					m_words.resize(wordIndex + 1, 0);
+				}
+				m_words[wordIndex] |= uint64_t(1) << (entityIndex % WORD_SIZE);
+			}
+
+			void reset(ECS::EntityId entityIndex)
+			{
+				const size_t wordIndex = entityIndex / WORD_SIZE;
+				if (wordIndex < m_words.size())
+				{
+					m_words[wordIndex] &= ~(uint64_t(1) << (entityIndex % WORD_SIZE));
+				}
+			}
+
+			bool test(ECS::EntityId entityIndex) const
+			{
+				const size_t wordIndex = entityIndex / WORD_SIZE;
+				return wordIndex < m_words.size() && (m_words[wordIndex] & (uint64_t(1) << (entityIndex % WORD_SIZE))) != 0;
+			}
+
+			// returns the word at wordIndex, 0 past the end of the bitmap.
+			uint64_t getWord(size_t wordIndex) const
+			{
+				return wordIndex < m_words.size() ? m_words[wordIndex] : 0;
+			}
+
+			size_t wordCount() const
+			{
+				return m_words.size();
+			}
+
+			// overwrites the word at wordIndex, growing the bitmap if needed.
+			void setWord(size_t wordIndex, uint64_t word)
+			{
+				if (wordIndex >= m_words.size())
+				{
+					m_words.resize(wordIndex + 1, 0);
+				}
+				m_words[wordIndex] = word;
+			}
+
+			// drops the words past bitCount. The bits past bitCount are expected to be reset.
+			void shrink(size_t bitCount)
+			{
+				m_words.resize((bitCount + WORD_SIZE - 1) / WORD_SIZE);
+				m_words.shrink_to_fit();
+			}
+
+			// returns the index of the lowest set bit of a non zero word.
+			static size_t findFirstSetBit(uint64_t word)
+			{
+				return static_cast<size_t>(std::countr_zero(word));
+			}
+
+		private:
+			std::vector<uint64_t> m_words;
+		};
+	}
+}
@@ -1,53 +1,61 @@
 #include "EntityContainer.h"
+#include "Snapshot.h"
+#include <algorithm>
 #include <assert.h>
 
 using namespace Mani;
 
-// EntityContainer::ComponentPool begin
-
-ECS::EntityContainer::ComponentPool::ComponentPool(size_t inElementsSize)
-	: elementSize(inElementsSize)
+ECS::EntityContainer::EntityContainer()
 {
-	capacity = INITIAL_COMPONENT_COUNT;
-	data = std::vector<unsigned char>(capacity * elementSize, 0);
+	// entities without any component live in the first archetype.
+	m_archetypes.push_back(new Archetype(Bitset<MAX_COMPONENTS>()));
 }
 
-void* ECS::EntityContainer::ComponentPool::get(size_t index)
+ECS::EntityContainer::~EntityContainer()
 {
-	if (index >= capacity)
+	for (ComponentPool* componentPool : m_componentPools)
 	{
-		// We don't have enough room. double the capacity until we do.
-		while (index >= capacity)
-		{
-			capacity *= 2;
-		}
+		delete componentPool;
+	}
+	m_componentPools.clear();
 
-		data.resize(capacity * elementSize);
+	for (Archetype* archetype : m_archetypes)
+	{
+		delete archetype;
 	}
+	m_archetypes.clear();
 
-	return &data[0] + index * elementSize;
+	for (QueryState* queryState : m_queries)
+	{
+		delete queryState;
+	}
+	m_queries.clear();
 }
 
-// EntityContainer::ComponentPool end
-
 ECS::EntityId ECS::EntityContainer::create()
 {
-	if (m_entities.size() >= UINT64_MAX && m_entityPool.size() == 0)
+	if (m_entities.size() >= ECS::ENTITY_INDEX_MASK && m_entityPool.size() == 0)
 	{
 		return ECS::INVALID_ID;
 	}
 
 	if (m_entityPool.size() > 0)
 	{
-		ECS::EntityId id = m_entityPool.back();
+		// the recycled entity's generation was bumped when it was destroyed.
+		const ECS::EntityId index = m_entityPool.back();
 		m_entityPool.pop_back();
-		m_entities[id].isAlive = true;
-		return id;
+		m_entities[index].isAlive = true;
+		m_aliveEntities.set(index);
+		moveEntity(m_entities[index].id, m_archetypes[0]);
+		return m_entities[index].id;
 	}
 
 	m_entities.push_back(ECS::Entity());
-	m_entities.back().id = m_entities.size() - 1;
+	m_entities.back().id = ECS::makeEntityId(m_entities.size() - 1, m_generationFloor);
 	m_entities.back().isAlive = true;
+	m_aliveEntities.set(m_entities.size() - 1);
+	m_archetypeRecords.push_back(ArchetypeRecord());
+	moveEntity(m_entities.back().id, m_archetypes[0]);
 	return m_entities.back().id;
 }
 
@@ -58,11 +66,32 @@ bool ECS::EntityContainer::destroy(ECS::EntityId entityId)
 		return false;
 	}
 
-	ECS::Entity& entity = m_entities[entityId];
+	const ECS::EntityId index = ECS::getEntityIndex(entityId);
+	ECS::Entity& entity = m_entities[index];
+	for (ComponentId componentId = 0; componentId < m_componentPools.size(); ++componentId)
+	{
+		if (entity.hasComponent(componentId))
+		{
+			m_componentPools[componentId]->remove(entityId);
+		}
+	}
+
 	entity.isAlive = false;
+	m_aliveEntities.reset(index);
 	entity.resetComponentBits();
+	moveEntity(entityId, nullptr);
 
-	m_entityPool.push_back(entity.id);
+	// invalidates the ids of this life. An index that ran out of generations is retired instead of recycled.
+	const ECS::EntityId nextGeneration = ECS::getEntityGeneration(entityId) + 1;
+	entity.id = ECS::makeEntityId(index, nextGeneration);
+	if (nextGeneration < ECS::MAX_ENTITY_GENERATION)
+	{
+		m_entityPool.push_back(index);
+	}
+	else
+	{
+		m_retiredEntityCount++;
+	}
 	return true;
 }
 
@@ -73,12 +102,12 @@ const ECS::Entity* ECS::EntityContainer::getEntity(ECS::EntityId entityId) const
 		return nullptr;
 	}
 
-	return &m_entities[entityId];
+	return &m_entities[ECS::getEntityIndex(entityId)];
 }
 
 size_t ECS::EntityContainer::size() const
 {
-	return m_entities.size() - m_entityPool.size();
+	return m_entities.size() - m_entityPool.size() - m_retiredEntityCount;
 }
 
 size_t ECS::EntityContainer::unadjustedSize() const
@@ -88,15 +117,12 @@ size_t ECS::EntityContainer::unadjustedSize() const
 
 bool ECS::EntityContainer::isValid(ECS::EntityId entityId) const
 {
-	if (entityId >= m_entities.size() || entityId == ECS::INVALID_ID)
-	{
-		return false;
-	}
-
-	return m_entities[entityId].isAlive;
+	// the generation check rejects ids of previous lives.
+	const ECS::EntityId index = ECS::getEntityIndex(entityId);
+	return m_aliveEntities.test(index) && m_entities[index].id == entityId;
 }
 
-void* ECS::EntityContainer::addComponent(ECS::EntityId entityId, ComponentId componentId, size_t componentSize)
+void* ECS::EntityContainer::addComponent(ECS::EntityId entityId, ComponentId componentId, const ComponentInfo& componentInfo)
 {
 	if (!isValid(entityId))
 	{
@@ -109,19 +135,16 @@ void* ECS::EntityContainer::addComponent(ECS::EntityId entityId, ComponentId com
 		return nullptr;
 	}
 
-	if (componentId >= m_componentPools.size())
-	{
-		m_componentPools.resize(componentId + 1, nullptr);
-	}
-	if (m_componentPools[componentId] == nullptr)
-	{
-		m_componentPools[componentId] = new ComponentPool(componentSize);
-	}
+	ComponentPool* componentPool = getOrCreateComponentPool(componentId, componentInfo);
 
-	Entity& entity = m_entities[entityId];
+	const ECS::EntityId index = ECS::getEntityIndex(entityId);
+	Entity& entity = m_entities[index];
 	entity.setComponentBit(componentId);
+	moveEntity(entityId, getNextArchetype(m_archetypeRecords[index].archetype, componentId, true));
 
-	return m_componentPools[componentId]->get(entityId);	
+	void* component = componentPool->add(entityId);
+	componentPool->markAdded(index, m_changeVersion);
+	return component;
 }
 
 void* ECS::EntityContainer::getComponent(ECS::EntityId entityId, ComponentId componentId) const
@@ -158,8 +181,12 @@ bool ECS::EntityContainer::removeComponent(ECS::EntityId entityId, ComponentId c
 		return false;
 	}
 
-	Entity& entity = m_entities[entityId];
+	m_componentPools[componentId]->remove(entityId);
+
+	const ECS::EntityId index = ECS::getEntityIndex(entityId);
+	Entity& entity = m_entities[index];
 	entity.resetComponentBit(componentId);
+	moveEntity(entityId, getNextArchetype(m_archetypeRecords[index].archetype, componentId, false));
 	return true;
 }
 
@@ -170,21 +197,604 @@ bool ECS::EntityContainer::hasComponent(ECS::EntityId entityId, ComponentId comp
 		return false;
 	}
 
-	return m_entities[entityId].hasComponent(componentId);
+	return m_entities[ECS::getEntityIndex(entityId)].hasComponent(componentId);
 }
 
-ECS::ComponentId ECS::EntityContainer::getComponentId(const std::type_index& typeIndex) const
+void ECS::EntityContainer::createMany(size_t count, std::vector<ECS::EntityId>& outEntityIds)
 {
-	std::unordered_map<std::type_index, ComponentId>* componentIds = const_cast<std::unordered_map<std::type_index, ComponentId>*>(&m_componentIds);
-	if (auto it = componentIds->find(typeIndex); it != componentIds->end())
+	// recycled entities come first, only the remaining ones need new storage.
+	const size_t newEntityCount = count - std::min(count, m_entityPool.size());
+	m_entities.reserve(m_entities.size() + newEntityCount);
+	m_archetypeRecords.reserve(m_archetypeRecords.size() + newEntityCount);
+	outEntityIds.reserve(outEntityIds.size() + count);
+
+	for (size_t i = 0; i < count; ++i)
 	{
-		return it->second;
+		const ECS::EntityId entityId = create();
+		if (entityId == ECS::INVALID_ID)
+		{
+			return;
+		}
+		outEntityIds.push_back(entityId);
 	}
-	else
+}
+
+bool ECS::EntityContainer::addComponents(
+	ECS::EntityId entityId,
+	std::span<const ComponentId> componentIds,
+	std::span<const ComponentInfo* const> componentInfos,
+	std::span<void*> outComponents
+)
+{
+	assert(componentIds.size() == componentInfos.size() && componentIds.size() == outComponents.size());
+	if (!isValid(entityId))
+	{
+		return false;
+	}
+
+	const ECS::EntityId index = ECS::getEntityIndex(entityId);
+	Entity& entity = m_entities[index];
+
+	// walk the archetype graph first so the entity only moves once.
+	Archetype* archetype = m_archetypeRecords[index].archetype;
+	for (size_t i = 0; i < componentIds.size(); ++i)
+	{
+		if (entity.hasComponent(componentIds[i]))
+		{
+			continue;
+		}
+		entity.setComponentBit(componentIds[i]);
+		archetype = getNextArchetype(archetype, componentIds[i], true);
+	}
+	moveEntity(entityId, archetype);
+
+	for (size_t i = 0; i < componentIds.size(); ++i)
+	{
+		ComponentPool* componentPool = getOrCreateComponentPool(componentIds[i], *componentInfos[i]);
+		const bool hadComponent = componentPool->getOccupancy().test(index);
+		if (hadComponent)
+		{
+			outComponents[i] = nullptr;
+			continue;
+		}
+
+		outComponents[i] = componentPool->add(entityId);
+		componentPool->markAdded(index, m_changeVersion);
+	}
+	return true;
+}
+
+void ECS::EntityContainer::reserveComponents(std::span<const ComponentId> componentIds, std::span<const ComponentInfo* const> componentInfos, size_t count)
+{
+	assert(componentIds.size() == componentInfos.size());
+	for (size_t i = 0; i < componentIds.size(); ++i)
+	{
+		getOrCreateComponentPool(componentIds[i], *componentInfos[i])->reserve(count);
+	}
+}
+
+const std::vector<ECS::Archetype*>& ECS::EntityContainer::getArchetypes() const
+{
+	return m_archetypes;
+}
+
+ECS::ComponentPool* ECS::EntityContainer::getComponentPool(ComponentId componentId) const
+{
+	if (componentId >= m_componentPools.size())
+	{
+		return nullptr;
+	}
+	return m_componentPools[componentId];
+}
+
+const ECS::EntityBitmap& ECS::EntityContainer::getAliveEntities() const
+{
+	return m_aliveEntities;
+}
+
+uint64_t ECS::EntityContainer::getStructuralChangeCount() const
+{
+	return m_structuralChangeCount;
+}
+
+ECS::EntityId ECS::EntityContainer::getEntityId(size_t index) const
+{
+	return m_entities[index].id;
+}
+
+uint32_t ECS::EntityContainer::getChangeVersion() const
+{
+	return m_changeVersion;
+}
+
+uint32_t ECS::EntityContainer::advanceChangeVersion()
+{
+	return m_changeVersion++;
+}
+
+bool ECS::EntityContainer::markComponentChanged(ECS::EntityId entityId, ComponentId componentId)
+{
+	if (!hasComponent(entityId, componentId))
+	{
+		return false;
+	}
+
+	m_componentPools[componentId]->markChanged(ECS::getEntityIndex(entityId), m_changeVersion);
+	return true;
+}
+
+ECS::QueryState* ECS::EntityContainer::registerQuery(const Bitset<MAX_COMPONENTS>& componentMask, const Bitset<MAX_COMPONENTS>& excludedComponentMask)
+{
+	for (QueryState* queryState : m_queries)
+	{
+		if (queryState->hasMasks(componentMask, excludedComponentMask))
+		{
+			return queryState;
+		}
+	}
+
+	QueryState* queryState = new QueryState(componentMask, excludedComponentMask);
+	m_queries.push_back(queryState);
+	attachQuery(queryState);
+	return queryState;
+}
+
+void ECS::EntityContainer::compact(std::vector<EntityRemap>& outRemap)
+{
+	// retired indices ran out of generations, they are never reused nor dropped.
+	auto isRetired = [this](size_t index)
+	{
+		return !m_entities[index].isAlive && ECS::getEntityGeneration(m_entities[index].id) >= ECS::MAX_ENTITY_GENERATION;
+	};
+
+	// fill the lowest free slots with the highest alive entities, entities below the first hole keep their ids.
+	size_t freeIndex = 0;
+	size_t aliveIndex = m_entities.size();
+	while (true)
+	{
+		while (aliveIndex > 0 && !m_entities[aliveIndex - 1].isAlive)
+		{
+			aliveIndex--;
+		}
+
+		while (freeIndex < aliveIndex && (m_entities[freeIndex].isAlive || isRetired(freeIndex)))
+		{
+			freeIndex++;
+		}
+
+		if (freeIndex >= aliveIndex)
+		{
+			break;
+		}
+
+		const ECS::EntityId entityId = m_entities[aliveIndex - 1].id;
+		outRemap.push_back({ entityId, renumberEntity(aliveIndex - 1, freeIndex) });
+	}
+
+	// the free slots past the last alive or retired entity are dropped. Their indices are created again starting
+	// above their generations, so the ids of their previous lives stay invalid.
+	size_t endIndex = m_entities.size();
+	while (endIndex > 0 && !m_entities[endIndex - 1].isAlive && !isRetired(endIndex - 1))
 	{
-		assert(componentIds->size() <= MAX_COMPONENTS);
-		ComponentId componentId = static_cast<ComponentId>(componentIds->size());
-		(*componentIds)[typeIndex] = componentId;
-		return componentId;
+		endIndex--;
+		m_generationFloor = std::max(m_generationFloor, ECS::getEntityGeneration(m_entities[endIndex].id));
 	}
+
+	// the remaining free slots are recycled lowest index first.
+	m_entityPool.clear();
+	m_retiredEntityCount = 0;
+	for (size_t index = endIndex; index-- > 0;)
+	{
+		if (isRetired(index))
+		{
+			m_retiredEntityCount++;
+		}
+		else if (!m_entities[index].isAlive)
+		{
+			m_entityPool.push_back(static_cast<ECS::EntityId>(index));
+		}
+	}
+	m_entityPool.shrink_to_fit();
+
+	m_entities.resize(endIndex);
+	m_entities.shrink_to_fit();
+	m_archetypeRecords.resize(endIndex);
+	m_archetypeRecords.shrink_to_fit();
+	m_aliveEntities.shrink(endIndex);
+
+	for (ComponentPool* componentPool : m_componentPools)
+	{
+		if (componentPool != nullptr)
+		{
+			componentPool->shrink(endIndex);
+		}
+	}
+
+	for (QueryState* queryState : m_queries)
+	{
+		queryState->shrink(endIndex);
+	}
+}
+
+void ECS::EntityContainer::writeSnapshot(std::ostream& stream, ComponentTypeRegistry& componentTypeRegistry) const
+{
+	writeSnapshotValue(stream, static_cast<uint64_t>(m_entities.size()));
+	for (const Entity& entity : m_entities)
+	{
+		writeSnapshotValue(stream, static_cast<uint64_t>(entity.id));
+		writeSnapshotValue(stream, static_cast<uint8_t>(entity.isAlive));
+	}
+
+	writeSnapshotValue(stream, static_cast<uint64_t>(m_entityPool.size()));
+	for (const ECS::EntityId index : m_entityPool)
+	{
+		writeSnapshotValue(stream, static_cast<uint64_t>(index));
+	}
+	writeSnapshotValue(stream, static_cast<uint64_t>(m_retiredEntityCount));
+	writeSnapshotValue(stream, static_cast<uint64_t>(m_generationFloor));
+
+	uint32_t poolCount = 0;
+	for (const ComponentPool* componentPool : m_componentPools)
+	{
+		poolCount += componentPool != nullptr && componentPool->getComponentInfo().isTriviallyCopyable ? 1 : 0;
+	}
+	writeSnapshotValue(stream, poolCount);
+
+	for (ComponentId componentId = 0; componentId < m_componentPools.size(); ++componentId)
+	{
+		const ComponentPool* componentPool = m_componentPools[componentId];
+		if (componentPool == nullptr || !componentPool->getComponentInfo().isTriviallyCopyable)
+		{
+			continue;
+		}
+
+		// the schema entry: component ids differ from a run to another, names do not.
+		const std::string name = componentTypeRegistry.getComponentName(componentId);
+		const ComponentInfo& componentInfo = componentPool->getComponentInfo();
+		writeSnapshotValue(stream, static_cast<uint32_t>(name.size()));
+		writeSnapshotBytes(stream, name.data(), name.size());
+		writeSnapshotValue(stream, static_cast<uint64_t>(componentInfo.size));
+		writeSnapshotValue(stream, static_cast<uint64_t>(componentInfo.alignment));
+		writeSnapshotValue(stream, static_cast<uint8_t>(componentInfo.storage));
+
+		componentPool->writeSnapshot(stream);
+	}
+}
+
+bool ECS::EntityContainer::readSnapshot(std::istream& stream, ComponentTypeRegistry& componentTypeRegistry)
+{
+	// the snapshot is read aside so a failure leaves the container as it was.
+	EntityContainer restored;
+	restored.m_changeVersion = m_changeVersion;
+	if (!restored.readSnapshotContent(stream, componentTypeRegistry))
+	{
+		return false;
+	}
+
+	// everything but the queries is swapped, restored releases the previous content.
+	std::swap(m_componentPools, restored.m_componentPools);
+	std::swap(m_archetypes, restored.m_archetypes);
+	std::swap(m_archetypeRecords, restored.m_archetypeRecords);
+	std::swap(m_entities, restored.m_entities);
+	std::swap(m_entityPool, restored.m_entityPool);
+	std::swap(m_retiredEntityCount, restored.m_retiredEntityCount);
+	std::swap(m_generationFloor, restored.m_generationFloor);
+	std::swap(m_aliveEntities, restored.m_aliveEntities);
+	m_structuralChangeCount++;
+
+	for (QueryState* queryState : m_queries)
+	{
+		queryState->clear();
+		attachQuery(queryState);
+	}
+	return true;
+}
+
+ECS::EntityId ECS::EntityContainer::renumberEntity(size_t index, size_t newIndex)
+{
+	// the free slot's id already carries the generation of its next life, ids of its previous lives stay invalid.
+	const ECS::EntityId entityId = m_entities[index].id;
+	const ECS::EntityId newEntityId = ECS::makeEntityId(newIndex, ECS::getEntityGeneration(m_entities[newIndex].id));
+
+	ECS::Entity& entity = m_entities[index];
+	m_structuralChangeCount++;
+	for (ComponentId componentId = 0; componentId < m_componentPools.size(); ++componentId)
+	{
+		if (entity.hasComponent(componentId))
+		{
+			m_componentPools[componentId]->renumber(entityId, newEntityId);
+		}
+	}
+
+	// the entity keeps its archetype row and its query rows.
+	const ArchetypeRecord record = m_archetypeRecords[index];
+	record.archetype->replace(record.row, newEntityId);
+	for (QueryState* queryState : record.archetype->getQueries())
+	{
+		queryState->replace(entityId, newEntityId);
+	}
+	m_archetypeRecords[newIndex] = record;
+	m_archetypeRecords[index] = ArchetypeRecord();
+
+	m_entities[newIndex] = entity;
+	m_entities[newIndex].id = newEntityId;
+	m_aliveEntities.set(newIndex);
+
+	// the old slot is freed like a destroyed entity's, ids of the entity's previous index become invalid.
+	entity.id = ECS::makeEntityId(index, ECS::getEntityGeneration(entityId) + 1);
+	entity.isAlive = false;
+	entity.resetComponentBits();
+	m_aliveEntities.reset(index);
+	return newEntityId;
+}
+
+void ECS::EntityContainer::attachQuery(QueryState* queryState)
+{
+	for (Archetype* archetype : m_archetypes)
+	{
+		if (!queryState->isMatching(archetype->getSignature()))
+		{
+			continue;
+		}
+
+		archetype->addQuery(queryState);
+		for (size_t row = 0; row < archetype->size(); ++row)
+		{
+			queryState->add(archetype->at(row));
+		}
+	}
+}
+
+bool ECS::EntityContainer::readSnapshotContent(std::istream& stream, ComponentTypeRegistry& componentTypeRegistry)
+{
+	uint64_t entityCount = 0;
+	if (!readSnapshotValue(stream, entityCount) || entityCount > ECS::ENTITY_INDEX_MASK)
+	{
+		return false;
+	}
+
+	m_entities.resize(entityCount);
+	m_archetypeRecords.resize(entityCount);
+	for (size_t index = 0; index < entityCount; ++index)
+	{
+		uint64_t entityId = 0;
+		uint8_t isAlive = 0;
+		if (!readSnapshotValue(stream, entityId) || !readSnapshotValue(stream, isAlive) || ECS::getEntityIndex(entityId) != index)
+		{
+			return false;
+		}
+
+		m_entities[index].id = static_cast<ECS::EntityId>(entityId);
+		m_entities[index].isAlive = isAlive != 0;
+		if (m_entities[index].isAlive)
+		{
+			m_aliveEntities.set(index);
+		}
+	}
+
+	uint64_t entityPoolSize = 0;
+	if (!readSnapshotValue(stream, entityPoolSize) || entityPoolSize > entityCount)
+	{
+		return false;
+	}
+
+	m_entityPool.resize(entityPoolSize);
+	for (ECS::EntityId& index : m_entityPool)
+	{
+		uint64_t pooledIndex = 0;
+		if (!readSnapshotValue(stream, pooledIndex) || pooledIndex >= entityCount)
+		{
+			return false;
+		}
+		index = static_cast<ECS::EntityId>(pooledIndex);
+	}
+
+	uint64_t retiredEntityCount = 0;
+	uint64_t generationFloor = 0;
+	uint32_t poolCount = 0;
+	if (!readSnapshotValue(stream, retiredEntityCount) ||
+		!readSnapshotValue(stream, generationFloor) ||
+		generationFloor >= ECS::MAX_ENTITY_GENERATION ||
+		!readSnapshotValue(stream, poolCount))
+	{
+		return false;
+	}
+	m_retiredEntityCount = static_cast<size_t>(retiredEntityCount);
+	m_generationFloor = static_cast<ECS::EntityId>(generationFloor);
+
+	for (uint32_t poolIndex = 0; poolIndex < poolCount; ++poolIndex)
+	{
+		uint32_t nameSize = 0;
+		if (!readSnapshotValue(stream, nameSize))
+		{
+			return false;
+		}
+
+		std::string name(nameSize, '\0');
+		uint64_t size = 0;
+		uint64_t alignment = 0;
+		uint8_t storage = 0;
+		if (!readSnapshotBytes(stream, name.data(), nameSize) ||
+			!readSnapshotValue(stream, size) ||
+			!readSnapshotValue(stream, alignment) ||
+			!readSnapshotValue(stream, storage))
+		{
+			return false;
+		}
+
+		ComponentId componentId = 0;
+		const ComponentInfo* componentInfo = componentTypeRegistry.findComponentId(name, componentId) ? componentTypeRegistry.getComponentInfo(componentId) : nullptr;
+		if (componentInfo == nullptr)
+		{
+			// the type is not used by this module, its components are read with the saved layout and dropped.
+			ComponentInfo skippedComponentInfo;
+			skippedComponentInfo.size = static_cast<size_t>(size);
+			skippedComponentInfo.alignment = static_cast<size_t>(alignment);
+			skippedComponentInfo.storage = static_cast<EComponentStorage>(storage);
+			skippedComponentInfo.isTriviallyCopyable = true;
+
+			ComponentPool* skippedComponentPool = createComponentPool(skippedComponentInfo);
+			const bool isRead = skippedComponentPool->readSnapshot(stream, static_cast<size_t>(entityCount));
+			delete skippedComponentPool;
+			if (!isRead)
+			{
+				return false;
+			}
+			continue;
+		}
+
+		if (!componentInfo->isTriviallyCopyable ||
+			componentInfo->size != size ||
+			componentInfo->alignment != alignment ||
+			static_cast<uint8_t>(componentInfo->storage) != storage)
+		{
+			return false;
+		}
+
+		ComponentPool* componentPool = getOrCreateComponentPool(componentId, *componentInfo);
+		if (!componentPool->readSnapshot(stream, static_cast<size_t>(entityCount)))
+		{
+			return false;
+		}
+
+		// rebuild the signatures from the pools, components are stamped as added now.
+		const EntityBitmap& occupancy = componentPool->getOccupancy();
+		for (size_t wordIndex = 0; wordIndex < occupancy.wordCount(); ++wordIndex)
+		{
+			uint64_t word = occupancy.getWord(wordIndex);
+			while (word != 0)
+			{
+				const size_t index = wordIndex * EntityBitmap::WORD_SIZE + EntityBitmap::findFirstSetBit(word);
+				if (!m_aliveEntities.test(index))
+				{
+					return false;
+				}
+
+				m_entities[index].setComponentBit(componentId);
+				componentPool->markAdded(index, m_changeVersion);
+				word &= word - 1;
+			}
+		}
+	}
+
+	for (size_t index = 0; index < m_entities.size(); ++index)
+	{
+		if (m_entities[index].isAlive)
+		{
+			moveEntity(m_entities[index].id, getArchetype(m_entities[index].getSignature()));
+		}
+	}
+	return true;
+}
+
+ECS::ComponentPool* ECS::EntityContainer::getOrCreateComponentPool(ComponentId componentId, const ComponentInfo& componentInfo)
+{
+	if (componentId >= m_componentPools.size())
+	{
+		m_componentPools.resize(componentId + 1, nullptr);
+	}
+
+	if (m_componentPools[componentId] == nullptr)
+	{
+		m_componentPools[componentId] = createComponentPool(componentInfo);
+	}
+	return m_componentPools[componentId];
+}
+
+ECS::ComponentPool* ECS::EntityContainer::createComponentPool(const ComponentInfo& componentInfo)
+{
+	switch (componentInfo.storage)
+	{
+		case EComponentStorage::SparseSet:
+			return new SparseSetComponentPool(componentInfo);
+		case EComponentStorage::Tag:
+			return new TagComponentPool(componentInfo);
+		case EComponentStorage::Indexed:
+		default:
+			return new IndexedComponentPool(componentInfo);
+	}
+}
+
+ECS::Archetype* ECS::EntityContainer::getArchetype(const Bitset<MAX_COMPONENTS>& signature)
+{
+	// there are only a handful of archetypes and transitions are cached, a linear search is enough.
+	for (Archetype* archetype : m_archetypes)
+	{
+		if (archetype->getSignature() == signature)
+		{
+			return archetype;
+		}
+	}
+
+	Archetype* archetype = new Archetype(signature);
+	for (QueryState* queryState : m_queries)
+	{
+		if (queryState->isMatching(signature))
+		{
+			archetype->addQuery(queryState);
+		}
+	}
+	m_archetypes.push_back(archetype);
+	return archetype;
+}
+
+ECS::Archetype* ECS::EntityContainer::getNextArchetype(Archetype* archetype, ComponentId componentId, bool isAdding)
+{
+	assert(archetype != nullptr);
+
+	Archetype::Edge& edge = archetype->getEdge(componentId);
+	Archetype*& nextArchetype = isAdding ? edge.add : edge.remove;
+	if (nextArchetype == nullptr)
+	{
+		Bitset<MAX_COMPONENTS> signature = archetype->getSignature();
+		signature.set(componentId, isAdding);
+		nextArchetype = getArchetype(signature);
+	}
+	return nextArchetype;
+}
+
+void ECS::EntityContainer::moveEntity(ECS::EntityId entityId, Archetype* archetype)
+{
+	ArchetypeRecord& record = m_archetypeRecords[ECS::getEntityIndex(entityId)];
+	if (record.archetype == archetype)
+	{
+		return;
+	}
+	m_structuralChangeCount++;
+
+	// queries matching both archetypes keep the entity.
+	if (record.archetype != nullptr)
+	{
+		for (QueryState* queryState : record.archetype->getQueries())
+		{
+			if (archetype == nullptr || !queryState->isMatching(archetype->getSignature()))
+			{
+				queryState->remove(entityId);
+			}
+		}
+	}
+
+	if (archetype != nullptr)
+	{
+		for (QueryState* queryState : archetype->getQueries())
+		{
+			if (record.archetype == nullptr || !queryState->isMatching(record.archetype->getSignature()))
+			{
+				queryState->add(entityId);
+			}
+		}
+	}
+
+	if (record.archetype != nullptr)
+	{
+		// the last entity of the archetype was moved in the freed row.
+		const ECS::EntityId movedEntityId = record.archetype->remove(record.row);
+		if (movedEntityId != ECS::INVALID_ID)
+		{
+			m_archetypeRecords[ECS::getEntityIndex(movedEntityId)].row = record.row;
+		}
+	}
+
+	record.archetype = archetype;
+	record.row = archetype != nullptr ? archetype->add(entityId) : 0;
 }
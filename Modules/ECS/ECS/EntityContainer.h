@@ -2,9 +2,15 @@
 
 #include <ECS.h>
 #include "Entity.h"
+#include "Archetype.h"
+#include "ComponentPool.h"
+#include "EntityBitmap.h"
+#include "QueryState.h"
+#include "ComponentType.h"
+#include <istream>
+#include <ostream>
+#include <span>
 #include <vector>
-#include <unordered_map>
-#include <typeindex>
 
 namespace Mani 
 {
@@ -12,12 +18,11 @@ namespace Mani
 	{
 		class EntityContainer
 		{
-
-	#define INITIAL_COMPONENT_COUNT 1000
-
 		public:
+			EntityContainer();
+
 			// IEntityContainer begin
-			virtual ~EntityContainer() = default;
+			virtual ~EntityContainer();
 			ECS::EntityId create();
 			bool destroy(ECS::EntityId entityId);
 			const Entity* getEntity(ECS::EntityId entityId) const;
@@ -25,29 +30,102 @@ namespace Mani
 			size_t unadjustedSize() const;
 			bool isValid(ECS::EntityId entityId) const;
 
-			void* addComponent(ECS::EntityId entityId, ComponentId componentId, size_t componentSize);
+			void* addComponent(ECS::EntityId entityId, ComponentId componentId, const ComponentInfo& componentInfo);
 			void* getComponent(ECS::EntityId entityId, ComponentId componentId) const;
-			ComponentId getComponentId(const std::type_index& typeIndex) const;
 			bool removeComponent(ECS::EntityId entityId, ComponentId componentId);
 			bool hasComponent(ECS::EntityId entityId, ComponentId componentId) const;
 			// IEntityContainer end
 
+			// creates count entities, their ids are appended to outEntityIds.
+			void createMany(size_t count, std::vector<ECS::EntityId>& outEntityIds);
+
+			// adds several components to an entity, moving it to its new archetype once.
+			// outComponents receives the storage of each component, nullptr for tags and for the components the entity already has.
+			// returns false if the entity is not valid.
+			bool addComponents(
+				ECS::EntityId entityId,
+				std::span<const ComponentId> componentIds,
+				std::span<const ComponentInfo* const> componentInfos,
+				std::span<void*> outComponents
+			);
+
+			// prepares the pools of componentIds to receive count more components.
+			void reserveComponents(std::span<const ComponentId> componentIds, std::span<const ComponentInfo* const> componentInfos, size_t count);
+
+			// archetypes are never destroyed, new archetypes are appended at the end.
+			const std::vector<Archetype*>& getArchetypes() const;
+
+			// returns the pool of a component type, nullptr if that component was never added.
+			ComponentPool* getComponentPool(ComponentId componentId) const;
+
+			// one bit per entity index, set while the entity is alive.
+			const EntityBitmap& getAliveEntities() const;
+
+			// bumped each time an entity changes archetype or is renumbered. Iterations holding a copy of entity ids compare it
+			// to know if the copied entities may have left their archetype.
+			uint64_t getStructuralChangeCount() const;
+
+			// returns the current id of the entity at index
+			ECS::EntityId getEntityId(size_t index) const;
+
+			// components added or marked changed are stamped with the change version. It starts at 1 so a version of 0 precedes every change.
+			uint32_t getChangeVersion() const;
+			// returns the current change version, later changes are stamped with the next one.
+			uint32_t advanceChangeVersion();
+			// returns false if the entity does not have the component.
+			bool markComponentChanged(ECS::EntityId entityId, ComponentId componentId);
+
+			// moves the alive entities with the highest indices in the free slots so indices are dense again, then releases
+			// the memory held for the free indices past the last alive entity. Retired indices are left where they are.
+			// each renumbered entity is appended to outRemap. The previous ids of the renumbered and dropped entities stay invalid.
+			void compact(std::vector<EntityRemap>& outRemap);
+
+			// writes the entities and the components of trivially copyable types as raw blobs, behind a header naming each component type.
+			// components of other types are not saved.
+			void writeSnapshot(std::ostream& stream, ComponentTypeRegistry& componentTypeRegistry) const;
+
+			// replaces the content of the container with a snapshot. Component types are matched by name, the components of types
+			// this module never used are skipped. Restored components are stamped as added at the current change version.
+			// returns false and leaves the container untouched if the snapshot is truncated or a component type changed layout.
+			bool readSnapshot(std::istream& stream, ComponentTypeRegistry& componentTypeRegistry);
+
+			// returns the persistent query matching the masks, it is created and filled with the matching entities on first use.
+			// queries live as long as the container and are kept up to date as entities change archetype.
+			QueryState* registerQuery(const Bitset<MAX_COMPONENTS>& componentMask, const Bitset<MAX_COMPONENTS>& excludedComponentMask);
+
 		private:
-			struct ComponentPool 
+			// where an entity lives in its archetype
+			struct ArchetypeRecord
 			{
-				ComponentPool(size_t inElementsSize);
-
-				inline void* get(size_t index);
-			
-				std::vector<unsigned char> data;
-				size_t capacity;
-				size_t elementSize;
+				Archetype* archetype = nullptr;
+				size_t row = 0;
 			};
 
+			static ComponentPool* createComponentPool(const ComponentInfo& componentInfo);
+			ComponentPool* getOrCreateComponentPool(ComponentId componentId, const ComponentInfo& componentInfo);
+			Archetype* getArchetype(const Bitset<MAX_COMPONENTS>& signature);
+			Archetype* getNextArchetype(Archetype* archetype, ComponentId componentId, bool isAdding);
+			void moveEntity(ECS::EntityId entityId, Archetype* archetype);
+			// moves the alive entity at index to the free slot at newIndex.
+			ECS::EntityId renumberEntity(size_t index, size_t newIndex);
+			// links a query to the archetypes matching it and adds their entities.
+			void attachQuery(QueryState* queryState);
+			// reads a snapshot into an empty container.
+			bool readSnapshotContent(std::istream& stream, ComponentTypeRegistry& componentTypeRegistry);
+
 			std::vector<ComponentPool*> m_componentPools;
+			std::vector<Archetype*> m_archetypes;
+			std::vector<QueryState*> m_queries;
+			std::vector<ArchetypeRecord> m_archetypeRecords;
 			std::vector<Entity> m_entities;
+			// indices of destroyed entities, waiting to be recycled.
 			std::vector<ECS::EntityId> m_entityPool;
-			std::unordered_map<std::type_index, ComponentId> m_componentIds;
+			size_t m_retiredEntityCount = 0;
+			// generation of the entities created at a new index. compact raises it above the generations of the indices it drops.
+			ECS::EntityId m_generationFloor = 0;
+			uint32_t m_changeVersion = 1;
+			uint64_t m_structuralChangeCount = 0;
+			EntityBitmap m_aliveEntities;
 		};
 	}
 }
\ No newline at end of file
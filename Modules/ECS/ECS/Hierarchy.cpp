@@ -0,0 +1,107 @@
+#include "Hierarchy.h"
+
+using namespace Mani;
+
+bool ECS::setParent(Registry& registry, ECS::EntityId entityId, ECS::EntityId parentId)
+{
+	if (!registry.isValid(entityId) || (parentId != ECS::INVALID_ID && !registry.isValid(parentId)))
+	{
+		return false;
+	}
+
+	// an entity can not be parented to itself or to one of its descendants.
+	if (parentId == entityId || isDescendantOf(registry, parentId, entityId))
+	{
+		return false;
+	}
+
+	Relationship* relationship = registry.get<Relationship>(entityId);
+	if (relationship == nullptr)
+	{
+		relationship = registry.add<Relationship>(entityId);
+	}
+
+	if (relationship->parent == parentId)
+	{
+		return true;
+	}
+
+	// unlink from the previous parent's children.
+	if (relationship->parent != ECS::INVALID_ID)
+	{
+		Relationship* previousParentRelationship = registry.get<Relationship>(relationship->parent);
+		if (previousParentRelationship->firstChild == entityId)
+		{
+			previousParentRelationship->firstChild = relationship->nextSibling;
+		}
+		if (relationship->previousSibling != ECS::INVALID_ID)
+		{
+			registry.get<Relationship>(relationship->previousSibling)->nextSibling = relationship->nextSibling;
+		}
+		if (relationship->nextSibling != ECS::INVALID_ID)
+		{
+			registry.get<Relationship>(relationship->nextSibling)->previousSibling = relationship->previousSibling;
+		}
+		previousParentRelationship->childCount--;
+	}
+
+	relationship->parent = parentId;
+	relationship->previousSibling = ECS::INVALID_ID;
+	relationship->nextSibling = ECS::INVALID_ID;
+	if (parentId == ECS::INVALID_ID)
+	{
+		return true;
+	}
+
+	// link as the new parent's first child.
+	Relationship* parentRelationship = registry.get<Relationship>(parentId);
+	if (parentRelationship == nullptr)
+	{
+		parentRelationship = registry.add<Relationship>(parentId);
+	}
+
+	if (parentRelationship->firstChild != ECS::INVALID_ID)
+	{
+		registry.get<Relationship>(parentRelationship->firstChild)->previousSibling = entityId;
+	}
+	relationship->nextSibling = parentRelationship->firstChild;
+	parentRelationship->firstChild = entityId;
+	parentRelationship->childCount++;
+	return true;
+}
+
+ECS::EntityId ECS::getParent(const Registry& registry, ECS::EntityId entityId)
+{
+	const Relationship* relationship = registry.get<Relationship>(entityId);
+	return relationship != nullptr ? relationship->parent : ECS::INVALID_ID;
+}
+
+bool ECS::isDescendantOf(const Registry& registry, ECS::EntityId entityId, ECS::EntityId ancestorId)
+{
+	ECS::EntityId parentId = getParent(registry, entityId);
+	while (parentId != ECS::INVALID_ID)
+	{
+		if (parentId == ancestorId)
+		{
+			return true;
+		}
+		parentId = getParent(registry, parentId);
+	}
+	return false;
+}
+
+size_t ECS::destroyRecursive(Registry& registry, ECS::EntityId entityId)
+{
+	if (!registry.isValid(entityId))
+	{
+		return 0;
+	}
+
+	std::vector<ECS::EntityId> entityIds;
+	entityIds.push_back(entityId);
+	eachDescendant(registry, entityId, [&entityIds](ECS::EntityId descendantId)
+	{
+		entityIds.push_back(descendantId);
+	});
+	return registry.destroyMany(entityIds);
+}
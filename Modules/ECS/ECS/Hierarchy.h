@@ -0,0 +1,98 @@
+#pragma once
+
+#include "ECS.h"
+#include "Entity.h"
+#include "Registry.h"
+#include "Relationship.h"
+#include <vector>
+
+namespace Mani
+{
+	namespace ECS
+	{
+		// makes parentId the parent of entityId, INVALID_ID detaches entityId from its parent.
+		// entityId becomes its new parent's first child. Both entities are given a Relationship if they do not have one.
+		// returns false if an entity is not valid or if parentId is entityId or one of its descendants.
+		bool setParent(Registry& registry, ECS::EntityId entityId, ECS::EntityId parentId);
+
+		// returns the parent of an entity, INVALID_ID if it has none.
+		ECS::EntityId getParent(const Registry& registry, ECS::EntityId entityId);
+
+		// returns true if ancestorId is the parent of entityId, or an ancestor of its parent.
+		bool isDescendantOf(const Registry& registry, ECS::EntityId entityId, ECS::EntityId ancestorId);
+
+		// destroys an entity and all its descendants with a single destroyMany.
+		// returns the amount of destroyed entities
+		size_t destroyRecursive(Registry& registry, ECS::EntityId entityId);
+
+		// calls func(childId) for each child of parentId, from the first to the last.
+		// the hierarchy must not be edited during the walk.
+		template<typename TFunc>
+		void eachChild(Registry& registry, ECS::EntityId parentId, TFunc&& func);
+
+		// calls func(descendantId) for each descendant of rootId, depth first: an entity is visited before its children.
+		// the walk follows the links and does not allocate. The hierarchy must not be edited during the walk.
+		template<typename TFunc>
+		void eachDescendant(Registry& registry, ECS::EntityId rootId, TFunc&& func);
+
+		// calls func(descendantId) for each descendant of rootId, breadth first: all the entities of a depth are visited before the next depth.
+		// queue holds the pending entities, reusing it between walks avoids allocations. The hierarchy must not be edited during the walk.
+		template<typename TFunc>
+		void eachDescendantBreadthFirst(Registry& registry, ECS::EntityId rootId, std::vector<ECS::EntityId>& queue, TFunc&& func);
+
+		template<typename TFunc>
+		inline void eachChild(Registry& registry, ECS::EntityId parentId, TFunc&& func)
+		{
+			const Relationship* relationship = registry.get<Relationship>(parentId);
+			ECS::EntityId childId = relationship != nullptr ? relationship->firstChild : ECS::INVALID_ID;
+			while (childId != ECS::INVALID_ID)
+			{
+				// the next sibling is read first, func may edit the child's other components.
+				const ECS::EntityId nextSiblingId = registry.get<Relationship>(childId)->nextSibling;
+				func(childId);
+				childId = nextSiblingId;
+			}
+		}
+
+		template<typename TFunc>
+		inline void eachDescendant(Registry& registry, ECS::EntityId rootId, TFunc&& func)
+		{
+			const Relationship* relationship = registry.get<Relationship>(rootId);
+			ECS::EntityId entityId = relationship != nullptr ? relationship->firstChild : ECS::INVALID_ID;
+			while (entityId != ECS::INVALID_ID)
+			{
+				func(entityId);
+
+				relationship = registry.get<Relationship>(entityId);
+				if (relationship->firstChild != ECS::INVALID_ID)
+				{
+					entityId = relationship->firstChild;
+					continue;
+				}
+
+				// no children, climb until an ancestor below the root has a next sibling.
+				while (entityId != rootId && relationship->nextSibling == ECS::INVALID_ID)
+				{
+					entityId = relationship->parent;
+					relationship = registry.get<Relationship>(entityId);
+				}
+				entityId = entityId != rootId ? relationship->nextSibling : ECS::INVALID_ID;
+			}
+		}
+
+		template<typename TFunc>
+		inline void eachDescendantBreadthFirst(Registry& registry, ECS::EntityId rootId, std::vector<ECS::EntityId>& queue, TFunc&& func)
+		{
+			queue.clear();
+			eachChild(registry, rootId, [&queue](ECS::EntityId childId) { queue.push_back(childId); });
+
+			// the queue is only appended to, it is walked by index.
+			for (size_t index = 0; index < queue.size(); ++index)
+			{
+				const ECS::EntityId entityId = queue[index];
+				func(entityId);
+				eachChild(registry, entityId, [&queue](ECS::EntityId childId) { queue.push_back(childId); });
+			}
+		}
+	}
+}
@@ -0,0 +1,42 @@
+#include "ParallelFor.h"
+
+using namespace Mani;
+
+namespace
+{
+	ECS::ParallelForFunction& getParallelForFunction()
+	{
+		static ECS::ParallelForFunction parallelForFunction;
+		return parallelForFunction;
+	}
+
+	void defaultParallelFor(size_t batchCount, const std::function<void(size_t)>& function)
+	{
+		for (size_t batchIndex = 0; batchIndex < batchCount; ++batchIndex)
+		{
+			function(batchIndex);
+		}
+	}
+}
+
+void ECS::setParallelFor(ParallelForFunction parallelForFunction)
+{
+	getParallelForFunction() = std::move(parallelForFunction);
+}
+
+void ECS::parallelFor(size_t batchCount, const std::function<void(size_t batchIndex)>& function)
+{
+	if (batchCount == 0)
+	{
+		return;
+	}
+
+	const ParallelForFunction& parallelForFunction = getParallelForFunction();
+	if (parallelForFunction)
+	{
+		parallelForFunction(batchCount, function);
+		return;
+	}
+
+	defaultParallelFor(batchCount, function);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "ECS.h"
+#include <functional>
+
+namespace Mani
+{
+	namespace ECS
+	{
+		// calls function(batchIndex) for each batch in [0, batchCount) and returns once every batch is done.
+		using ParallelForFunction = std::function<void(size_t batchCount, const std::function<void(size_t batchIndex)>& function)>;
+
+		/*
+		 * Replaces the function used to dispatch the batches of View::parallelEach, e.g. with the application's job system.
+		 * An empty function restores the default, which runs the batches in order on the calling thread: starting threads
+		 * on each call would cost more than most iterations.
+		 * There is one parallel for per module linking the ECS library. It is expected to be set before any iteration starts.
+		 */
+		void setParallelFor(ParallelForFunction parallelForFunction);
+
+		// runs the batches with the current parallel for.
+		void parallelFor(size_t batchCount, const std::function<void(size_t batchIndex)>& function);
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "ECS.h"
+#include "Registry.h"
+#include "View.h"
+#include "QueryState.h"
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace Mani
+{
+    namespace ECS
+    {
+        /*
+         * A persistent View: the registry keeps the list of its matching entities up to date as components are added and removed,
+         * iterating a query costs O(matches) no matter how many entities and archetypes the registry holds.
+         * Queries with the same components share their state. Build them once, e.g. when a system initializes, and reuse them every tick.
+         */
+        template<typename ...TComponents>
+        class Query
+        {
+        public:
+            Query() = default;
+
+            Query(Registry& registry, uint32_t sinceVersion = 0)
+                : m_view(registry, sinceVersion),
+                m_state(registry.m_entityContainer.registerQuery(m_view.m_componentMask, m_view.m_excludedComponentMask))
+            {
+            }
+
+            // calls function(EntityId, TComponents&...) for each entity of the query, with the same arguments as View::each.
+            // entities are visited from the last matching one to the first so the current entity can be destroyed or edited
+            // during the iteration. Entities matching the query during the iteration are not visited.
+            template<typename TFunction>
+            void each(TFunction&& function) const;
+
+            // returns the amount of entities matching the query, before applying its Changed and Added filters.
+            size_t size() const;
+
+            // Changed and Added components must have been stamped after sinceVersion, see Registry::advanceChangeVersion.
+            void setSinceVersion(uint32_t sinceVersion);
+
+        private:
+            View<TComponents...> m_view;
+            const QueryState* m_state = nullptr;
+
+            template<typename TFunction, size_t ...TIndices>
+            void each(TFunction& function, const std::array<ComponentPool*, sizeof...(TComponents)>& pools, std::index_sequence<TIndices...>) const;
+        };
+
+        template<typename ...TComponents>
+        template<typename TFunction>
+        inline void Query<TComponents...>::each(TFunction&& function) const
+        {
+            std::array<ComponentPool*, sizeof...(TComponents)> pools;
+            if (m_state == nullptr || !m_view.getComponentPools(pools))
+            {
+                return;
+            }
+
+            each(function, pools, std::index_sequence_for<TComponents...>());
+        }
+
+        template<typename ...TComponents>
+        template<typename TFunction, size_t ...TIndices>
+        inline void Query<TComponents...>::each(TFunction& function, const std::array<ComponentPool*, sizeof...(TComponents)>& pools, std::index_sequence<TIndices...>) const
+        {
+            const std::vector<ECS::EntityId>& entityIds = m_state->getEntityIds();
+            size_t row = entityIds.size();
+            while (row > 0)
+            {
+                // the function may have removed several entities from the query.
+                row = std::min(row, entityIds.size());
+                if (row == 0)
+                {
+                    break;
+                }
+                --row;
+
+                if (m_view.isVersionMatching(entityIds[row]))
+                {
+                    View<TComponents...>::invoke(function, entityIds[row], pools, std::index_sequence<TIndices...>());
+                }
+            }
+        }
+
+        template<typename ...TComponents>
+        inline size_t Query<TComponents...>::size() const
+        {
+            return m_state != nullptr ? m_state->getEntityIds().size() : 0;
+        }
+
+        template<typename ...TComponents>
+        inline void Query<TComponents...>::setSinceVersion(uint32_t sinceVersion)
+        {
+            m_view.m_sinceVersion = sinceVersion;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#include "QueryState.h"
+#include <algorithm>
+#include <assert.h>
+
+using namespace Mani;
+
+ECS::QueryState::QueryState(const Bitset<MAX_COMPONENTS>& inComponentMask, const Bitset<MAX_COMPONENTS>& inExcludedComponentMask)
+	: m_componentMask(inComponentMask),
+	m_excludedComponentMask(inExcludedComponentMask)
+{
+}
+
+bool ECS::QueryState::isMatching(const Bitset<MAX_COMPONENTS>& signature) const
+{
+	return signature.contains(m_componentMask) && !signature.intersects(m_excludedComponentMask);
+}
+
+bool ECS::QueryState::hasMasks(const Bitset<MAX_COMPONENTS>& componentMask, const Bitset<MAX_COMPONENTS>& excludedComponentMask) const
+{
+	return m_componentMask == componentMask && m_excludedComponentMask == excludedComponentMask;
+}
+
+void ECS::QueryState::add(ECS::EntityId entityId)
+{
+	const ECS::EntityId entityIndex = ECS::getEntityIndex(entityId);
+	if (entityIndex >= m_rows.size())
+	{
+		m_rows.resize(entityIndex + 1, INVALID_ROW);
+	}
+	assert(m_rows[entityIndex] == INVALID_ROW);
+
+	m_rows[entityIndex] = m_entityIds.size();
+	m_entityIds.push_back(entityId);
+}
+
+void ECS::QueryState::replace(ECS::EntityId entityId, ECS::EntityId newEntityId)
+{
+	const ECS::EntityId entityIndex = ECS::getEntityIndex(entityId);
+	const ECS::EntityId newEntityIndex = ECS::getEntityIndex(newEntityId);
+	if (newEntityIndex >= m_rows.size())
+	{
+		m_rows.resize(newEntityIndex + 1, INVALID_ROW);
+	}
+
+	const size_t row = m_rows[entityIndex];
+	m_entityIds[row] = newEntityId;
+	m_rows[newEntityIndex] = row;
+	m_rows[entityIndex] = INVALID_ROW;
+}
+
+void ECS::QueryState::shrink(size_t entityCount)
+{
+	m_rows.resize(std::min(m_rows.size(), entityCount));
+	m_rows.shrink_to_fit();
+	m_entityIds.shrink_to_fit();
+}
+
+void ECS::QueryState::clear()
+{
+	m_entityIds.clear();
+	m_rows.clear();
+}
+
+void ECS::QueryState::remove(ECS::EntityId entityId)
+{
+	const ECS::EntityId entityIndex = ECS::getEntityIndex(entityId);
+	if (entityIndex >= m_rows.size() || m_rows[entityIndex] == INVALID_ROW)
+	{
+		return;
+	}
+
+	const size_t row = m_rows[entityIndex];
+	const ECS::EntityId lastEntityId = m_entityIds.back();
+	m_entityIds[row] = lastEntityId;
+	m_rows[ECS::getEntityIndex(lastEntityId)] = row;
+
+	m_entityIds.pop_back();
+	m_rows[entityIndex] = INVALID_ROW;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "ECS.h"
+#include "Entity.h"
+#include "Bitset.h"
+#include <vector>
+
+namespace Mani
+{
+	namespace ECS
+	{
+		/*
+		 * The entities matching a persistent query, kept in a dense array.
+		 * The entity container adds and removes entities as their signature changes, iterating costs O(matches).
+		 */
+		class QueryState
+		{
+		public:
+			QueryState(const Bitset<MAX_COMPONENTS>& inComponentMask, const Bitset<MAX_COMPONENTS>& inExcludedComponentMask);
+
+			// returns true if a signature holds all the required components and none of the excluded ones.
+			bool isMatching(const Bitset<MAX_COMPONENTS>& signature) const;
+
+			bool hasMasks(const Bitset<MAX_COMPONENTS>& componentMask, const Bitset<MAX_COMPONENTS>& excludedComponentMask) const;
+
+			void add(ECS::EntityId entityId);
+
+			// removes an entity, the last entity of the query takes its place.
+			void remove(ECS::EntityId entityId);
+
+			const std::vector<ECS::EntityId>& getEntityIds() const;
+
+			// gives the row of entityId to newEntityId, used when an entity is renumbered.
+			void replace(ECS::EntityId entityId, ECS::EntityId newEntityId);
+
+			// drops the rows kept for the entity indices past entityCount, which are expected to have left the query.
+			void shrink(size_t entityCount);
+
+			// removes every entity from the query
+			void clear();
+
+		private:
+			static constexpr size_t INVALID_ROW = SIZE_MAX;
+
+			Bitset<MAX_COMPONENTS> m_componentMask;
+			Bitset<MAX_COMPONENTS> m_excludedComponentMask;
+			std::vector<ECS::EntityId> m_entityIds;
+			// row of each entity index in m_entityIds
+			std::vector<size_t> m_rows;
+		};
+
+		inline const std::vector<ECS::EntityId>& QueryState::getEntityIds() const
+		{
+			return m_entityIds;
+		}
+	}
+}
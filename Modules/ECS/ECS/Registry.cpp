@@ -1,3 +1,95 @@
 #include "Registry.h"
+#include "Hierarchy.h"
+#include "View.h"
+#include <unordered_map>
 
 using namespace Mani;
+
+void ECS::Registry::unlinkRelationship(ECS::EntityId entityId)
+{
+	Relationship* relationship = get<Relationship>(entityId);
+	if (relationship == nullptr)
+	{
+		return;
+	}
+
+	// the children become roots, their siblings links go with the parent.
+	ECS::EntityId childId = relationship->firstChild;
+	while (childId != ECS::INVALID_ID)
+	{
+		Relationship* childRelationship = get<Relationship>(childId);
+		const ECS::EntityId nextSiblingId = childRelationship->nextSibling;
+		childRelationship->parent = ECS::INVALID_ID;
+		childRelationship->previousSibling = ECS::INVALID_ID;
+		childRelationship->nextSibling = ECS::INVALID_ID;
+		childId = nextSiblingId;
+	}
+	relationship->firstChild = ECS::INVALID_ID;
+	relationship->childCount = 0;
+
+	setParent(*this, entityId, ECS::INVALID_ID);
+}
+
+void ECS::Registry::remapRelationships(std::span<const EntityRemap> entityRemaps)
+{
+	if (m_entityContainer.getComponentPool(getComponentId<Relationship>()) == nullptr)
+	{
+		return;
+	}
+
+	std::unordered_map<ECS::EntityId, ECS::EntityId> newEntityIds;
+	newEntityIds.reserve(entityRemaps.size());
+	for (const EntityRemap& entityRemap : entityRemaps)
+	{
+		newEntityIds[entityRemap.oldId] = entityRemap.newId;
+	}
+
+	auto remap = [&newEntityIds](ECS::EntityId& entityId)
+	{
+		if (auto it = newEntityIds.find(entityId); it != newEntityIds.end())
+		{
+			entityId = it->second;
+		}
+	};
+
+	ECS::View<Relationship> relationshipView(*this);
+	relationshipView.each([&remap](ECS::EntityId, Relationship& relationship)
+	{
+		remap(relationship.parent);
+		remap(relationship.firstChild);
+		remap(relationship.previousSibling);
+		remap(relationship.nextSibling);
+	});
+}
+
+ECS::Registry::ForeignComponentIds& ECS::Registry::getForeignComponentIds(const ComponentTypeRegistry& componentTypeRegistry) const
+{
+	for (ForeignComponentIds* foreignComponentIds = m_foreignComponentIds.load(std::memory_order_acquire); foreignComponentIds != nullptr; foreignComponentIds = foreignComponentIds->next)
+	{
+		if (foreignComponentIds->componentTypeRegistry == &componentTypeRegistry)
+		{
+			return *foreignComponentIds;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_foreignComponentIdsMutex);
+
+	// another thread of the module may have added the table while waiting for the lock.
+	for (ForeignComponentIds* foreignComponentIds = m_foreignComponentIds.load(std::memory_order_acquire); foreignComponentIds != nullptr; foreignComponentIds = foreignComponentIds->next)
+	{
+		if (foreignComponentIds->componentTypeRegistry == &componentTypeRegistry)
+		{
+			return *foreignComponentIds;
+		}
+	}
+
+	ForeignComponentIds* foreignComponentIds = new ForeignComponentIds();
+	foreignComponentIds->componentTypeRegistry = &componentTypeRegistry;
+	for (std::atomic<ComponentId>& componentId : foreignComponentIds->componentIds)
+	{
+		componentId.store(INVALID_COMPONENT_ID, std::memory_order_relaxed);
+	}
+	foreignComponentIds->next = m_foreignComponentIds.load(std::memory_order_relaxed);
+	m_foreignComponentIds.store(foreignComponentIds, std::memory_order_release);
+	return *foreignComponentIds;
+}
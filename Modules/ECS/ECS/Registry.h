@@ -3,22 +3,36 @@
 #include "ECS.h"
 #include "EntityContainer.h"
 #include "Entity.h"
+#include "ComponentType.h"
+#include "Relationship.h"
+#include "Snapshot.h"
 #include <Events/Event.h>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <span>
+#include <vector>
 
 namespace Mani
 {
 	namespace ECS
 	{
+		// tags have no storage, adding one returns whether it was added.
+		template<typename TComponent>
+		using ComponentAddResult = std::conditional_t<isTagComponent<TComponent>(), bool, TComponent*>;
+
 		/*
 		 * Holds a collection of entity and manage their component's memory.
 		 */
 		class Registry
 		{
-#define INITIAL_COMPONENT_COUNT 1000
 		public:
 			template<typename ...TComponents>
 			friend class View;
 
+			template<typename ...TComponents>
+			friend class Query;
+
 			DECLARE_EVENT(EntityEvent, Registry& /*registry*/, EntityId /*entityId*/);
 			DECLARE_EVENT(EntityComponentEvent, Registry& /*registry*/, EntityId /*entityId*/, ComponentId /*componentId*/);
 
@@ -28,29 +42,55 @@ namespace Mani
 			EntityComponentEvent onComponentAdded;
 			EntityComponentEvent onComponentRemoved;
 
+			DECLARE_EVENT(EntitiesEvent, Registry& /*registry*/, std::span<const EntityId> /*entityIds*/);
+			DECLARE_EVENT(EntitiesComponentEvent, Registry& /*registry*/, std::span<const EntityId> /*entityIds*/, ComponentId /*componentId*/);
+
+			// broadcast once by the bulk operations, in place of the per entity events.
+			EntitiesEvent onEntitiesCreated;
+			EntitiesEvent onBeforeEntitiesDestroyed;
+			EntitiesEvent onEntitiesDestroyed;
+			EntitiesComponentEvent onComponentsAdded;
+
+			DECLARE_EVENT(EntitiesRemappedEvent, Registry& /*registry*/, std::span<const EntityRemap> /*entityRemaps*/);
+
+			// broadcast by compact with the entities it renumbered, holders of entity ids fix them up from it.
+			EntitiesRemappedEvent onEntitiesRemapped;
+
 			Registry();
 			~Registry();
 
 			// creates an entity id
 			ECS::EntityId create();
 
-			// destroys an entity and its components
+			// destroys an entity and its components. The entity leaves its parent and its children become roots.
 			bool destroy(ECS::EntityId entityId);
+
+			// creates count entities, their ids are appended to outEntityIds.
+			void createMany(size_t count, std::vector<ECS::EntityId>& outEntityIds);
+
+			// destroys entities and their components
+			// returns the amount of destroyed entities
+			size_t destroyMany(std::span<const ECS::EntityId> entityIds);
+
+			// adds default constructed TComponents to each entity, entities move to their new archetype once.
+			// components an entity already has are left untouched.
+			template<typename ...TComponents>
+			void emplaceMany(std::span<const ECS::EntityId> entityIds);
 			
 			// returs an entity object
 			const Entity* getEntity(ECS::EntityId entityId) const;
 
 			// adds a TComponent to an entity
-			// returns the added component
+			// returns the added component, or true if TComponent is a tag.
 			template<typename TComponent>
-			TComponent* add(ECS::EntityId entityId);
+			ComponentAddResult<TComponent> add(ECS::EntityId entityId);
 
 			// removes a TComponent to an entity
 			// returns true if a component was removed
 			template<typename TComponent>
 			bool remove(ECS::EntityId entityId);
 
-			// returns an entity's TComponent
+			// returns an entity's TComponent. Tags have no storage, use has.
 			template<typename TComponent>
 			TComponent* get(ECS::EntityId entityId);
 
@@ -58,14 +98,23 @@ namespace Mani
 			template<typename TComponent>
 			const TComponent* get(ECS::EntityId entityId) const;
 
+			// returns an entity's TComponent and marks it changed, Changed<TComponent> views will visit it.
+			template<typename TComponent>
+			TComponent* getMut(ECS::EntityId entityId);
+
+			// marks an entity's TComponent changed, e.g. after editing it in a View::each.
+			// returns false if the entity does not have the component.
+			template<typename TComponent>
+			bool markChanged(ECS::EntityId entityId);
+
 			// returns true if an entity has a component (fast)
 			template<typename TComponent>
 			bool has(ECS::EntityId entityId) const;
 
 			// adds a singleton TComponent
-			// returns the added component
+			// returns the added component, or true if TComponent is a tag.
 			template<typename TComponent>
-			TComponent* addSingle();
+			ComponentAddResult<TComponent> addSingle();
 
 			// removes a singleton TComponent
 			// returns true if a component was removed
@@ -92,57 +141,185 @@ namespace Mani
 			// returns true if an entity with entityId exists and is alive
 			bool isValid(ECS::EntityId entityId) const;
 
+			// components added or marked changed are stamped with the current change version.
+			uint32_t getChangeVersion() const;
+			// returns the current change version and moves to the next one. A system tracking changes keeps the returned
+			// version and builds its next Changed or Added views with it, they visit what changed after this call.
+			uint32_t advanceChangeVersion();
+
+			// renumbers the alive entities so their indices are dense again and releases the memory held for destroyed entities.
+			// the links of Relationship components are remapped by the registry.
+			// entity ids held outside of the registry must be fixed with outRemap, or onEntitiesRemapped. Ids of destroyed
+			// entities must be dropped: once the registry grows again they may be given to new entities.
+			// views, queries and component pointers must not be in use during the call.
+			// the renumbered entities are appended to outRemap.
+			void compact(std::vector<EntityRemap>& outRemap);
+
+			// writes the entities and their trivially copyable components to stream as a binary snapshot.
+			// components of other types are not saved, their entities are restored without them.
+			// snapshots are raw memory, only a build of the same application on the same platform can restore them.
+			void snapshot(std::ostream& stream) const;
+
+			// replaces the entities and components of the registry with a snapshot. Entity ids and generations are kept,
+			// persistent queries are refilled and restored components count as added at the current change version.
+			// no entity or component event is broadcast.
+			// returns false and leaves the registry untouched if the snapshot can not be restored.
+			bool restore(std::istream& stream);
+
 			// Converts a TComponent type into a numerical identifier.
 			template<typename TComponent>
 			ComponentId getComponentId() const;
 
 		private:
+			// detaches an entity from its parent and from its children before it is destroyed.
+			void unlinkRelationship(ECS::EntityId entityId);
+			// fixes the links of Relationship components after a compaction.
+			void remapRelationships(std::span<const EntityRemap> entityRemaps);
+
+			/*
+			 * The ids resolved through m_componentTypeRegistry by a module that did not create the registry, indexed by
+			 * the module's own component ids. Tables are only ever added, they are read without locking.
+			 */
+			struct ForeignComponentIds
+			{
+				const ComponentTypeRegistry* componentTypeRegistry = nullptr;
+				std::array<std::atomic<ComponentId>, MAX_COMPONENTS> componentIds;
+				ForeignComponentIds* next = nullptr;
+			};
+
+			// returns the table of the module owning componentTypeRegistry, adds it on the module's first call.
+			ForeignComponentIds& getForeignComponentIds(const ComponentTypeRegistry& componentTypeRegistry) const;
+
 			ECS::EntityId m_singletonId;
+			// the component types of the module that created the registry.
+			ComponentTypeRegistry* m_componentTypeRegistry = nullptr;
+			mutable std::atomic<ForeignComponentIds*> m_foreignComponentIds = nullptr;
+			mutable std::mutex m_foreignComponentIdsMutex;
 			EntityContainer m_entityContainer;
 		};
 
 		template<typename TComponent>
-		inline TComponent* Registry::add(ECS::EntityId entityId)
+		inline ComponentAddResult<TComponent> Registry::add(ECS::EntityId entityId)
 		{
-			const ComponentId componentId = m_entityContainer.getComponentId(typeid(TComponent));
+			const ComponentId componentId = getComponentId<TComponent>();
 
-			void* buffer = m_entityContainer.addComponent(entityId, componentId, sizeof(TComponent));
-			if (buffer == nullptr)
+			if constexpr (isTagComponent<TComponent>())
 			{
-				return nullptr;
+				// a tag has no storage to tell whether it was added, check the entity first.
+				if (m_entityContainer.hasComponent(entityId, componentId) || !m_entityContainer.isValid(entityId))
+				{
+					return false;
+				}
+
+				m_entityContainer.addComponent(entityId, componentId, getComponentInfo<TComponent>());
+				onComponentAdded.broadcast(*this, entityId, componentId);
+				return true;
+			}
+			else
+			{
+				void* buffer = m_entityContainer.addComponent(entityId, componentId, getComponentInfo<TComponent>());
+				if (buffer == nullptr)
+				{
+					return nullptr;
+				}
+
+				// this is a placement new
+				TComponent* component = new (buffer) TComponent();
+				onComponentAdded.broadcast(*this, entityId, componentId);
+				return component;
+			}
+		}
+
+		template<typename ...TComponents>
+		inline void Registry::emplaceMany(std::span<const ECS::EntityId> entityIds)
+		{
+			constexpr size_t componentCount = sizeof...(TComponents);
+			const std::array<ComponentId, componentCount> componentIds{ getComponentId<TComponents>()... };
+			const std::array<const ComponentInfo*, componentCount> componentInfos{ &getComponentInfo<TComponents>()... };
+			m_entityContainer.reserveComponents(componentIds, componentInfos, entityIds.size());
+
+			std::array<std::vector<ECS::EntityId>, componentCount> addedEntityIds;
+			std::array<void*, componentCount> buffers;
+			for (const ECS::EntityId entityId : entityIds)
+			{
+				// tags have no storage, a null buffer does not tell whether they were added.
+				const std::array<bool, componentCount> hadComponents{ m_entityContainer.hasComponent(entityId, getComponentId<TComponents>())... };
+				if (!m_entityContainer.addComponents(entityId, componentIds, componentInfos, buffers))
+				{
+					continue;
+				}
+
+				// this is a placement new
+				size_t componentIndex = 0;
+				([&]()
+				{
+					if (!hadComponents[componentIndex])
+					{
+						if constexpr (!isTagComponent<TComponents>())
+						{
+							new (buffers[componentIndex]) TComponents();
+						}
+						addedEntityIds[componentIndex].push_back(entityId);
+					}
+					componentIndex++;
+				}(), ...);
 			}
 
-			// this is a placement new
-			TComponent* component = new (buffer) TComponent();
-			onComponentAdded.broadcast(*this, entityId, componentId);
-			return component;
+			for (size_t i = 0; i < componentCount; ++i)
+			{
+				if (!addedEntityIds[i].empty())
+				{
+					onComponentsAdded.broadcast(*this, addedEntityIds[i], componentIds[i]);
+				}
+			}
 		}
 
 		template<typename TComponent>
 		inline TComponent* Registry::get(ECS::EntityId entityId)
 		{
-			const ComponentId componentId = m_entityContainer.getComponentId(typeid(TComponent));
+			static_assert(!isTagComponent<TComponent>(), "Tags have no storage, use has.");
+			const ComponentId componentId = getComponentId<TComponent>();
+			return static_cast<TComponent*>(m_entityContainer.getComponent(entityId, componentId));
+		}
+
+		template<typename TComponent>
+		inline TComponent* Registry::getMut(ECS::EntityId entityId)
+		{
+			static_assert(!isTagComponent<TComponent>(), "Tags have no storage, use has.");
+			const ComponentId componentId = getComponentId<TComponent>();
+			if (!m_entityContainer.markComponentChanged(entityId, componentId))
+			{
+				return nullptr;
+			}
 			return static_cast<TComponent*>(m_entityContainer.getComponent(entityId, componentId));
 		}
 
+		template<typename TComponent>
+		inline bool Registry::markChanged(ECS::EntityId entityId)
+		{
+			static_assert(!isTagComponent<TComponent>(), "Tags have no change versions.");
+			return m_entityContainer.markComponentChanged(entityId, getComponentId<TComponent>());
+		}
+
 		template<typename TComponent>
 		inline bool Registry::has(ECS::EntityId entityId) const
 		{
-			const ComponentId componentId = m_entityContainer.getComponentId(typeid(TComponent));
+			const ComponentId componentId = getComponentId<TComponent>();
 			return m_entityContainer.hasComponent(entityId, componentId);
 		}
 
 		template<typename TComponent>
 		inline const TComponent* Registry::get(ECS::EntityId entityId) const
 		{
-			const ComponentId componentId = m_entityContainer.getComponentId(typeid(TComponent));
+			static_assert(!isTagComponent<TComponent>(), "Tags have no storage, use has.");
+			const ComponentId componentId = getComponentId<TComponent>();
 			return static_cast<const TComponent*>(m_entityContainer.getComponent(entityId, componentId));;
 		}
 
 		template<typename TComponent>
 		inline bool Registry::remove(ECS::EntityId entityId)
 		{
-			const ComponentId componentId = m_entityContainer.getComponentId(typeid(TComponent));
+			const ComponentId componentId = getComponentId<TComponent>();
 			if (m_entityContainer.removeComponent(entityId, componentId))
 			{
 				onComponentRemoved.broadcast(*this, entityId, componentId);
@@ -152,7 +329,7 @@ namespace Mani
 		}
 
 		template<typename TComponent>
-		inline TComponent* Registry::addSingle()
+		inline ComponentAddResult<TComponent> Registry::addSingle()
 		{
 			return add<TComponent>(m_singletonId);
 		}
@@ -184,17 +361,40 @@ namespace Mani
 		template<typename TComponent>
 		inline ComponentId Registry::getComponentId() const
 		{
-			return m_entityContainer.getComponentId(typeid(TComponent));
+			const ComponentTypeRegistry& componentTypeRegistry = ComponentTypeRegistry::get();
+			const ComponentId localComponentId = getComponentTypeId<TComponent>();
+			if (m_componentTypeRegistry == &componentTypeRegistry)
+			{
+				return localComponentId;
+			}
+
+			// the registry was created by another module, use the ids it was created with. They are resolved once per type.
+			std::atomic<ComponentId>& foreignComponentId = getForeignComponentIds(componentTypeRegistry).componentIds[localComponentId];
+			ComponentId componentId = foreignComponentId.load(std::memory_order_acquire);
+			if (componentId == INVALID_COMPONENT_ID)
+			{
+				componentId = m_componentTypeRegistry->getComponentId(typeid(TComponent).name(), &getComponentInfo<TComponent>());
+				foreignComponentId.store(componentId, std::memory_order_release);
+			}
+			return componentId;
 		}
 
 		inline Registry::Registry()
+			: m_componentTypeRegistry(&ComponentTypeRegistry::get())
 		{
 			m_singletonId = create();
 		}
 
 		inline Registry::~Registry()
 		{
-			destroy(m_singletonId);
+			// the entity container destroys the remaining components. Nothing is broadcast: subscribers may already be gone.
+			ForeignComponentIds* foreignComponentIds = m_foreignComponentIds.load();
+			while (foreignComponentIds != nullptr)
+			{
+				ForeignComponentIds* next = foreignComponentIds->next;
+				delete foreignComponentIds;
+				foreignComponentIds = next;
+			}
 		}
 
 		inline ECS::EntityId Registry::create()
@@ -207,6 +407,7 @@ namespace Mani
 		inline bool Registry::destroy(ECS::EntityId entityId)
 		{
 			onBeforeEntityDestroyed.broadcast(*this, entityId);
+			unlinkRelationship(entityId);
 			if (m_entityContainer.destroy(entityId))
 			{
 				onEntityDestroyed.broadcast(*this, entityId);
@@ -215,6 +416,50 @@ namespace Mani
 			return false;
 		}
 
+		inline void Registry::createMany(size_t count, std::vector<ECS::EntityId>& outEntityIds)
+		{
+			const size_t firstIndex = outEntityIds.size();
+			m_entityContainer.createMany(count, outEntityIds);
+			if (outEntityIds.size() > firstIndex)
+			{
+				onEntitiesCreated.broadcast(*this, std::span<const ECS::EntityId>(outEntityIds).subspan(firstIndex));
+			}
+		}
+
+		inline size_t Registry::destroyMany(std::span<const ECS::EntityId> entityIds)
+		{
+			std::vector<ECS::EntityId> validEntityIds;
+			validEntityIds.reserve(entityIds.size());
+			for (const ECS::EntityId entityId : entityIds)
+			{
+				if (isValid(entityId))
+				{
+					validEntityIds.push_back(entityId);
+				}
+			}
+
+			if (validEntityIds.empty())
+			{
+				return 0;
+			}
+
+			onBeforeEntitiesDestroyed.broadcast(*this, validEntityIds);
+
+			std::vector<ECS::EntityId> destroyedEntityIds;
+			destroyedEntityIds.reserve(validEntityIds.size());
+			for (const ECS::EntityId entityId : validEntityIds)
+			{
+				unlinkRelationship(entityId);
+				if (m_entityContainer.destroy(entityId))
+				{
+					destroyedEntityIds.push_back(entityId);
+				}
+			}
+
+			onEntitiesDestroyed.broadcast(*this, destroyedEntityIds);
+			return destroyedEntityIds.size();
+		}
+
 		inline const Entity* Registry::getEntity(ECS::EntityId entityId) const
 		{
 			return m_entityContainer.getEntity(entityId);
@@ -234,5 +479,63 @@ namespace Mani
 		{
 			return m_entityContainer.isValid(entityId);
 		}
+
+		inline uint32_t Registry::getChangeVersion() const
+		{
+			return m_entityContainer.getChangeVersion();
+		}
+
+		inline uint32_t Registry::advanceChangeVersion()
+		{
+			return m_entityContainer.advanceChangeVersion();
+		}
+
+		inline void Registry::compact(std::vector<EntityRemap>& outRemap)
+		{
+			const size_t remapOffset = outRemap.size();
+			m_entityContainer.compact(outRemap);
+
+			const std::span<const EntityRemap> entityRemaps(outRemap.data() + remapOffset, outRemap.size() - remapOffset);
+			for (const EntityRemap& entityRemap : entityRemaps)
+			{
+				if (entityRemap.oldId == m_singletonId)
+				{
+					m_singletonId = entityRemap.newId;
+				}
+			}
+
+			if (!entityRemaps.empty())
+			{
+				remapRelationships(entityRemaps);
+				onEntitiesRemapped.broadcast(*this, entityRemaps);
+			}
+		}
+
+		inline void Registry::snapshot(std::ostream& stream) const
+		{
+			writeSnapshotValue(stream, SNAPSHOT_MAGIC);
+			writeSnapshotValue(stream, SNAPSHOT_VERSION);
+			writeSnapshotValue(stream, static_cast<uint64_t>(m_singletonId));
+			m_entityContainer.writeSnapshot(stream, *m_componentTypeRegistry);
+		}
+
+		inline bool Registry::restore(std::istream& stream)
+		{
+			uint32_t magic = 0;
+			uint32_t version = 0;
+			if (!readSnapshotValue(stream, magic) || !readSnapshotValue(stream, version) || magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION)
+			{
+				return false;
+			}
+
+			uint64_t singletonId = 0;
+			if (!readSnapshotValue(stream, singletonId) || !m_entityContainer.readSnapshot(stream, *m_componentTypeRegistry))
+			{
+				return false;
+			}
+
+			m_singletonId = static_cast<ECS::EntityId>(singletonId);
+			return true;
+		}
 	}
 }
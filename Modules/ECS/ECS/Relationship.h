@@ -0,0 +1,24 @@
+#pragma once
+
+#include "ECS.h"
+#include "Entity.h"
+
+namespace Mani
+{
+	namespace ECS
+	{
+		/*
+		 * Links an entity to its parent and to its siblings. The children of an entity form an intrusive list starting
+		 * at its firstChild: walking a hierarchy only follows these links and does not allocate.
+		 * Edit the links with ECS::setParent, the registry keeps them consistent when entities are destroyed or renumbered.
+		 */
+		struct Relationship
+		{
+			EntityId parent = INVALID_ID;
+			EntityId firstChild = INVALID_ID;
+			EntityId previousSibling = INVALID_ID;
+			EntityId nextSibling = INVALID_ID;
+			size_t childCount = 0;
+		};
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "ECS.h"
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+namespace Mani
+{
+	namespace ECS
+	{
+		// registry snapshots start with this tag and version. Snapshots are raw memory: they are only meant
+		// to be restored by a build of the same application on the same platform.
+		const uint32_t SNAPSHOT_MAGIC = 0x5343454D; // "MECS"
+		const uint32_t SNAPSHOT_VERSION = 2;
+
+		template<typename TValue>
+		void writeSnapshotValue(std::ostream& stream, const TValue& value)
+		{
+			static_assert(std::is_trivially_copyable_v<TValue>);
+			stream.write(reinterpret_cast<const char*>(&value), sizeof(TValue));
+		}
+
+		// returns false if the stream ended before the value.
+		template<typename TValue>
+		bool readSnapshotValue(std::istream& stream, TValue& outValue)
+		{
+			static_assert(std::is_trivially_copyable_v<TValue>);
+			return static_cast<bool>(stream.read(reinterpret_cast<char*>(&outValue), sizeof(TValue)));
+		}
+
+		inline void writeSnapshotBytes(std::ostream& stream, const void* data, size_t size)
+		{
+			stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+		}
+
+		// returns false if the stream ended before size bytes were read.
+		inline bool readSnapshotBytes(std::istream& stream, void* outData, size_t size)
+		{
+			return static_cast<bool>(stream.read(static_cast<char*>(outData), static_cast<std::streamsize>(size)));
+		}
+	}
+}
@@ -4,49 +4,150 @@
 #include "Registry.h"
 #include "Entity.h"
 #include "Bitset.h"
+#include "Archetype.h"
+#include "ParallelFor.h"
+#include "EntityBitmap.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
 #include <cassert>
 
 namespace Mani
 {
     namespace ECS
     {
+        // default amount of entities in a View::parallelEach batch.
+        const size_t DEFAULT_PARALLEL_GRAIN_SIZE = 1024;
+
+        enum class EParallelMode : uint8_t
+        {
+            // batches run concurrently on the parallel for's workers.
+            Parallel,
+            // batches run one after the other on the calling thread, always in the same order. Useful for replays and debugging.
+            Deterministic
+        };
+
+        // skips the entities having TComponent, e.g. View<Transform, Exclude<Hidden>>
+        template<typename TComponent>
+        struct Exclude {};
+
+        // hands out TComponent as a pointer, nullptr when the entity doesn't have it. e.g. View<Transform, Optional<Sprite>>
+        template<typename TComponent>
+        struct Optional {};
+
+        // only lets in the entities whose TComponent was added or marked changed after the view's version. TComponent is not passed to functions.
+        template<typename TComponent>
+        struct Changed {};
+
+        // only lets in the entities whose TComponent was added after the view's version. TComponent is not passed to functions.
+        template<typename TComponent>
+        struct Added {};
+
+        enum class EViewFilter : uint8_t
+        {
+            Required,
+            Exclude,
+            Optional,
+            Changed,
+            Added
+        };
+
+        // returns true if an entity must have the component to be part of a view.
+        constexpr bool isRequiredFilter(EViewFilter filter)
+        {
+            return filter == EViewFilter::Required || filter == EViewFilter::Changed || filter == EViewFilter::Added;
+        }
+
+        // returns true if the filter compares the component's change versions.
+        constexpr bool isVersionFilter(EViewFilter filter)
+        {
+            return filter == EViewFilter::Changed || filter == EViewFilter::Added;
+        }
+
+        template<typename TComponent>
+        struct ViewComponentTraits
+        {
+            using Component = TComponent;
+            static constexpr EViewFilter filter = EViewFilter::Required;
+        };
+
+        template<typename TComponent>
+        struct ViewComponentTraits<Exclude<TComponent>>
+        {
+            using Component = TComponent;
+            static constexpr EViewFilter filter = EViewFilter::Exclude;
+        };
+
+        template<typename TComponent>
+        struct ViewComponentTraits<Optional<TComponent>>
+        {
+            using Component = TComponent;
+            static constexpr EViewFilter filter = EViewFilter::Optional;
+        };
+
+        template<typename TComponent>
+        struct ViewComponentTraits<Changed<TComponent>>
+        {
+            static_assert(!isTagComponent<TComponent>(), "Tags have no change versions.");
+            using Component = TComponent;
+            static constexpr EViewFilter filter = EViewFilter::Changed;
+        };
+
+        template<typename TComponent>
+        struct ViewComponentTraits<Added<TComponent>>
+        {
+            static_assert(!isTagComponent<TComponent>(), "Tags have no change versions.");
+            using Component = TComponent;
+            static constexpr EViewFilter filter = EViewFilter::Added;
+        };
+
         /*
          * Allows a client to iterate over a view of entities with a specified set of components
+         * Components wrapped in Exclude or Optional do not restrict the view to the entities having them.
+         * Changed and Added compare the components' change versions with sinceVersion, e.g. View<Transform, Changed<Transform>>(registry, lastVersion)
+         * with lastVersion returned by Registry::advanceChangeVersion.
          */
         template<typename ...TComponents>
         class View
         {
         public:
+            template<typename ...TQueryComponents>
+            friend class Query;
+
             View() = default;
 
-            View(const Registry& registry)
-                : m_registry(&registry)
+            View(const Registry& registry, uint32_t inSinceVersion = 0)
+                : m_registry(&registry),
+                m_componentIds{ registry.getComponentId<typename ViewComponentTraits<TComponents>::Component>()... },
+                m_sinceVersion(inSinceVersion)
             {
-                if (sizeof...(TComponents) == 0)
-                {
-                    m_bisAll = true;
-                }
-                else
+                for (size_t i = 0; i < m_componentIds.size(); ++i)
                 {
-                    // The compiler complains if we allocate an array of size 0. So, we start the array with 0.
-                   const ComponentId componentIds[] = { 0, registry.getComponentId<TComponents>() ... };
-                    for (size_t i = 1; i < (sizeof...(TComponents) + 1); ++i)
+                    if (isRequiredFilter(s_filters[i]))
+                    {
+                        m_componentMask.set(m_componentIds[i]);
+                    }
+                    else if (s_filters[i] == EViewFilter::Exclude)
                     {
-                        m_componentMask.set(componentIds[i]);
+                        m_excludedComponentMask.set(m_componentIds[i]);
                     }
                 }
             }
 
+            /*
+             * Walks the entities matching the view when the iteration started: the archetypes matching the view's components,
+             * or the dense entities of the smallest sparse set pool when it holds fewer entities than the matching archetypes.
+             * The ids are copied up front so entities can be destroyed or edited during the iteration: each entity is visited
+             * once at most, the ones destroyed or leaving the view before their turn are skipped.
+             */
             struct Iterator
             {
                 Iterator() = default;
 
-                Iterator(
-                    const Registry* inRegistry,
-                    ECS::EntityId inCurrentEntityId,
-                    Bitset<Mani::ECS::MAX_COMPONENTS> inComponentMask,
-                    bool inIsAll
-                );
+                Iterator(const View* inView, std::shared_ptr<const std::vector<ECS::EntityId>> inEntityIds, bool inAreIdsMatching, uint64_t inStructuralChangeCount);
 
                 ECS::EntityId operator*() const;
                 bool operator==(const Iterator& other) const;
@@ -54,113 +155,546 @@ namespace Mani
                 Iterator& operator++();
 
             private:
-                ECS::EntityId m_currentEntityId;
-                const Registry* m_registry;
-                size_t m_size;
-                Bitset<Mani::ECS::MAX_COMPONENTS> m_componentMask;
-                bool m_isAll = false;
+                const View* m_view = nullptr;
+                // the entities to visit, entities created during the iteration are not visited.
+                std::shared_ptr<const std::vector<ECS::EntityId>> m_entityIds;
+                size_t m_index = 0;
+                // true if the ids matched the view's masks when they were copied.
+                bool m_areIdsMatching = false;
+                uint64_t m_structuralChangeCount = 0;
 
-                bool isValidIndex(const ECS::EntityId id) const;
+                bool isEnd() const;
+                // skips the entities that were destroyed or no longer pass the view's filters.
+                void seekMatchingEntity();
             };
 
             const Iterator begin() const
             {
-                if (m_bisAll)
+                std::shared_ptr<std::vector<ECS::EntityId>> entityIds = std::make_shared<std::vector<ECS::EntityId>>();
+                const uint64_t structuralChangeCount = m_registry->m_entityContainer.getStructuralChangeCount();
+                const bool areIdsMatching = collectEntityIds(*entityIds);
+                return Iterator(this, std::move(entityIds), areIdsMatching, structuralChangeCount);
+            }
+
+            const Iterator end() const
+            {
+                return Iterator();
+            }
+
+            // calls function(EntityId, TComponents&...) for each entity of the view. Optional components are passed as pointers,
+            // excluded components and Changed or Added filters are not passed. Component pools are resolved once for the whole
+            // iteration. Dense views are walked in ascending id order by scanning the pools' occupancy bitmaps a word at a time.
+            // Entities or components destroyed during the iteration are not visited, entities created during the iteration may be.
+            template<typename TFunction>
+            void each(TFunction&& function) const;
+
+            // calls function(EntityId, TComponents&...) for each entity of the view, split in batches of at most grainSize entities
+            // dispatched with ECS::parallelFor. function is called concurrently: it should only edit the components it is given,
+            // and entities or components must not be created nor removed until parallelEach returns.
+            template<typename TFunction>
+            void parallelEach(TFunction&& function, size_t grainSize = DEFAULT_PARALLEL_GRAIN_SIZE, EParallelMode mode = EParallelMode::Parallel) const;
+
+        private:
+            // a range of rows of an archetype, or of the driving pool when archetype is nullptr.
+            struct Batch
+            {
+                const Archetype* archetype = nullptr;
+                size_t beginRow = 0;
+                size_t endRow = 0;
+            };
+
+            static constexpr std::array<EViewFilter, sizeof...(TComponents)> s_filters{ ViewComponentTraits<TComponents>::filter... };
+            static constexpr bool s_hasVersionFilters = (isVersionFilter(ViewComponentTraits<TComponents>::filter) || ...);
+
+            const Registry* m_registry = nullptr;
+            std::array<ComponentId, sizeof...(TComponents)> m_componentIds;
+            // components an entity must have to be part of the view.
+            Bitset<ECS::MAX_COMPONENTS> m_componentMask;
+            // components an entity must not have to be part of the view.
+            Bitset<ECS::MAX_COMPONENTS> m_excludedComponentMask;
+            // Changed and Added components must have been stamped after this version.
+            uint32_t m_sinceVersion = 0;
+
+            // returns true if a signature holds all the required components and none of the excluded ones.
+            static bool isMatching(const Bitset<MAX_COMPONENTS>& signature, const Bitset<MAX_COMPONENTS>& componentMask, const Bitset<MAX_COMPONENTS>& excludedComponentMask);
+
+            // returns true if the entity passes the view's Changed and Added filters. The entity is expected to match the view's masks.
+            bool isVersionMatching(ECS::EntityId entityId) const;
+
+            // returns false if one of the view's required components was never added, no entity can match then.
+            bool getComponentPools(std::array<ComponentPool*, sizeof...(TComponents)>& outPools) const;
+
+            // returns the amount of entities in the archetypes matching the view.
+            size_t countMatchingEntities() const;
+
+            // returns the smallest sparse set pool of the view if it holds fewer entities than the matching archetypes.
+            const SparseSetComponentPool* findDrivingPool(size_t matchingEntityCount) const;
+
+            // appends the ids of the matching archetypes' entities, or of the driving pool's entities.
+            // returns true if the ids all match the view's masks, driving pool entities are not filtered.
+            bool collectEntityIds(std::vector<ECS::EntityId>& outEntityIds) const;
+
+            // returns true if an entity copied by collectEntityIds is alive and passes the view's filters. Entities matching the masks when
+            // they were copied only need their versions checked as long as no entity changed archetype since structuralChangeCount.
+            bool isVisitable(ECS::EntityId entityId, bool isMatchingWhenCollected, uint64_t structuralChangeCount) const;
+
+            template<typename TFunction, size_t ...TIndices>
+            void each(TFunction& function, const std::array<ComponentPool*, sizeof...(TComponents)>& pools, std::index_sequence<TIndices...>) const;
+
+            template<typename TFunction, size_t ...TIndices>
+            void eachSetBit(TFunction& function, const std::array<ComponentPool*, sizeof...(TComponents)>& pools, std::index_sequence<TIndices...>) const;
+
+            template<typename TFunction, size_t ...TIndices>
+            void runBatch(
+                TFunction& function,
+                const Batch& batch,
+                const SparseSetComponentPool* drivingPool,
+                const std::array<ComponentPool*, sizeof...(TComponents)>& pools,
+                std::index_sequence<TIndices...>
+            ) const;
+
+            // calls function with entityId and the arguments matching the view's components.
+            template<typename TFunction, size_t ...TIndices>
+            static void invoke(TFunction& function, ECS::EntityId entityId, const std::array<ComponentPool*, sizeof...(TComponents)>& pools, std::index_sequence<TIndices...>);
+
+            // returns a tuple holding the argument passed to functions for TComponent: a reference, a pointer or nothing.
+            template<typename TComponent>
+            static auto getArgument(ComponentPool* pool, ECS::EntityId entityId);
+
+            // returns the bits of the entities a component lets in the view for the word at wordIndex.
+            static uint64_t getFilterWord(EViewFilter filter, const ComponentPool* pool, size_t wordIndex);
+
+            // returns entityId's component without going through the pool's virtual interface.
+            static void* getComponent(ComponentPool* pool, ECS::EntityId entityId);
+
+            // returns entityId's TComponent, tags resolve to a shared empty instance.
+            template<typename TComponent>
+            static TComponent* getTypedComponent(ComponentPool* pool, ECS::EntityId entityId);
+        };
+
+        template<typename ...TComponents>
+        template<typename TFunction>
+        inline void View<TComponents...>::each(TFunction&& function) const
+        {
+            std::array<ComponentPool*, sizeof...(TComponents)> pools;
+            if (!getComponentPools(pools))
+            {
+                return;
+            }
+
+            // one word holds a matching entity on average, scanning the bitmaps beats walking the archetypes' rows.
+            const size_t matchingEntityCount = countMatchingEntities();
+            const bool isDense = matchingEntityCount * EntityBitmap::WORD_SIZE >= m_registry->m_entityContainer.unadjustedSize();
+            if (isDense && findDrivingPool(matchingEntityCount) == nullptr)
+            {
+                eachSetBit(function, pools, std::index_sequence_for<TComponents...>());
+                return;
+            }
+
+            each(function, pools, std::index_sequence_for<TComponents...>());
+        }
+
+        template<typename ...TComponents>
+        template<typename TFunction>
+        inline void View<TComponents...>::parallelEach(TFunction&& function, size_t grainSize, EParallelMode mode) const
+        {
+            assert(grainSize > 0);
+
+            std::array<ComponentPool*, sizeof...(TComponents)> pools;
+            if (!getComponentPools(pools))
+            {
+                return;
+            }
+
+            // batches are cut on the calling thread, they only depend on the view's content and grainSize.
+            std::vector<Batch> batches;
+            const SparseSetComponentPool* drivingPool = findDrivingPool(countMatchingEntities());
+            if (drivingPool != nullptr)
+            {
+                for (size_t row = 0; row < drivingPool->size(); row += grainSize)
                 {
-                    return Iterator(m_registry, 0, m_componentMask, m_bisAll);
+                    batches.push_back({ nullptr, row, std::min(row + grainSize, drivingPool->size()) });
                 }
-
-                ECS::EntityId entityId = 0;
-                for (; entityId < m_registry->unadjustedSize(); ++entityId)
+            }
+            else
+            {
+                for (const Archetype* archetype : m_registry->m_entityContainer.getArchetypes())
                 {
-                    if (!m_registry->isValid(entityId))
+                    if (!isMatching(archetype->getSignature(), m_componentMask, m_excludedComponentMask))
                     {
                         continue;
                     }
 
-                    if (m_registry->getEntity(entityId)->hasComponents(m_componentMask))
+                    for (size_t row = 0; row < archetype->size(); row += grainSize)
                     {
-                        break;
+                        batches.push_back({ archetype, row, std::min(row + grainSize, archetype->size()) });
                     }
                 }
+            }
+
+            auto runBatchAt = [this, &function, &batches, drivingPool, &pools](size_t batchIndex)
+            {
+                runBatch(function, batches[batchIndex], drivingPool, pools, std::index_sequence_for<TComponents...>());
+            };
+
+            if (mode == EParallelMode::Deterministic)
+            {
+                for (size_t batchIndex = 0; batchIndex < batches.size(); ++batchIndex)
+                {
+                    runBatchAt(batchIndex);
+                }
+                return;
+            }
+
+            parallelFor(batches.size(), runBatchAt);
+        }
 
-                return Iterator(m_registry, entityId, m_componentMask, m_bisAll);
+        template<typename ...TComponents>
+        inline bool View<TComponents...>::getComponentPools(std::array<ComponentPool*, sizeof...(TComponents)>& outPools) const
+        {
+            for (size_t i = 0; i < outPools.size(); ++i)
+            {
+                outPools[i] = m_registry->m_entityContainer.getComponentPool(m_componentIds[i]);
+                if (outPools[i] == nullptr && isRequiredFilter(s_filters[i]))
+                {
+                    return false;
+                }
             }
+            return true;
+        }
 
-            const Iterator end() const
+        template<typename ...TComponents>
+        template<typename TFunction, size_t ...TIndices>
+        inline void View<TComponents...>::each(TFunction& function, const std::array<ComponentPool*, sizeof...(TComponents)>& pools, std::index_sequence<TIndices...>) const
+        {
+            // the ids are copied first, function may move the entities in their archetype or pool.
+            std::vector<ECS::EntityId> entityIds;
+            const uint64_t structuralChangeCount = m_registry->m_entityContainer.getStructuralChangeCount();
+            const bool areIdsMatching = collectEntityIds(entityIds);
+            for (const ECS::EntityId entityId : entityIds)
             {
-                return Iterator(m_registry, m_registry->unadjustedSize(), m_componentMask, m_bisAll);
+                if (isVisitable(entityId, areIdsMatching, structuralChangeCount))
+                {
+                    invoke(function, entityId, pools, std::index_sequence<TIndices...>());
+                }
             }
+        }
 
-        private:
-            const Registry* m_registry = nullptr;
-            Bitset<ECS::MAX_COMPONENTS> m_componentMask;
-            bool m_bisAll = false;
-        };
+        template<typename ...TComponents>
+        template<typename TFunction, size_t ...TIndices>
+        inline void View<TComponents...>::eachSetBit(TFunction& function, const std::array<ComponentPool*, sizeof...(TComponents)>& pools, std::index_sequence<TIndices...>) const
+        {
+            const EntityContainer& entityContainer = m_registry->m_entityContainer;
+            const EntityBitmap& aliveEntities = entityContainer.getAliveEntities();
+            auto loadWord = [&aliveEntities, &pools](size_t wordIndex)
+            {
+                return (aliveEntities.getWord(wordIndex) & ... & getFilterWord(s_filters[TIndices], pools[TIndices], wordIndex));
+            };
+
+            // words appended during the iteration only hold entities created during the iteration.
+            const size_t wordCount = aliveEntities.wordCount();
+            for (size_t wordIndex = 0; wordIndex < wordCount; ++wordIndex)
+            {
+                uint64_t word = loadWord(wordIndex);
+                while (word != 0)
+                {
+                    const size_t bit = EntityBitmap::findFirstSetBit(word);
+                    const ECS::EntityId entityId = entityContainer.getEntityId(wordIndex * EntityBitmap::WORD_SIZE + bit);
+                    if (isVersionMatching(entityId))
+                    {
+                        invoke(function, entityId, pools, std::index_sequence<TIndices...>());
+                    }
+
+                    // function may have removed entities or components, reload the word and drop the bits already visited.
+                    word = loadWord(wordIndex) & ((~uint64_t(0) << bit) << 1);
+                }
+            }
+        }
+
+        template<typename ...TComponents>
+        template<typename TFunction, size_t ...TIndices>
+        inline void View<TComponents...>::runBatch(
+            TFunction& function,
+            const Batch& batch,
+            const SparseSetComponentPool* drivingPool,
+            const std::array<ComponentPool*, sizeof...(TComponents)>& pools,
+            std::index_sequence<TIndices...>
+        ) const
+        {
+            if (batch.archetype != nullptr)
+            {
+                for (size_t row = batch.beginRow; row < batch.endRow; ++row)
+                {
+                    const ECS::EntityId entityId = batch.archetype->at(row);
+                    if (isVersionMatching(entityId))
+                    {
+                        invoke(function, entityId, pools, std::index_sequence<TIndices...>());
+                    }
+                }
+                return;
+            }
+
+            const EntityContainer& entityContainer = m_registry->m_entityContainer;
+            for (size_t row = batch.beginRow; row < batch.endRow; ++row)
+            {
+                const ECS::EntityId entityId = drivingPool->getEntityId(row);
+                const Entity* entity = entityContainer.getEntity(entityId);
+                if (entity != nullptr && isMatching(entity->getSignature(), m_componentMask, m_excludedComponentMask) && isVersionMatching(entityId))
+                {
+                    invoke(function, entityId, pools, std::index_sequence<TIndices...>());
+                }
+            }
+        }
+
+        template<typename ...TComponents>
+        inline bool View<TComponents...>::isMatching(const Bitset<MAX_COMPONENTS>& signature, const Bitset<MAX_COMPONENTS>& componentMask, const Bitset<MAX_COMPONENTS>& excludedComponentMask)
+        {
+            return signature.contains(componentMask) && !signature.intersects(excludedComponentMask);
+        }
+
+        template<typename ...TComponents>
+        inline bool View<TComponents...>::isVersionMatching(ECS::EntityId entityId) const
+        {
+            if constexpr (!s_hasVersionFilters)
+            {
+                return true;
+            }
+
+            const EntityContainer& entityContainer = m_registry->m_entityContainer;
+            const size_t entityIndex = ECS::getEntityIndex(entityId);
+            for (size_t i = 0; i < m_componentIds.size(); ++i)
+            {
+                if (s_filters[i] == EViewFilter::Changed && entityContainer.getComponentPool(m_componentIds[i])->getChangedVersion(entityIndex) <= m_sinceVersion)
+                {
+                    return false;
+                }
+                if (s_filters[i] == EViewFilter::Added && entityContainer.getComponentPool(m_componentIds[i])->getAddedVersion(entityIndex) <= m_sinceVersion)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template<typename ...TComponents>
+        template<typename TFunction, size_t ...TIndices>
+        inline void View<TComponents...>::invoke(TFunction& function, ECS::EntityId entityId, const std::array<ComponentPool*, sizeof...(TComponents)>& pools, std::index_sequence<TIndices...>)
+        {
+            std::apply(function, std::tuple_cat(std::tuple<ECS::EntityId>(entityId), getArgument<TComponents>(pools[TIndices], entityId)...));
+        }
+
+        template<typename ...TComponents>
+        template<typename TComponent>
+        inline auto View<TComponents...>::getArgument(ComponentPool* pool, ECS::EntityId entityId)
+        {
+            using Component = typename ViewComponentTraits<TComponent>::Component;
+            constexpr EViewFilter filter = ViewComponentTraits<TComponent>::filter;
+
+            if constexpr (filter == EViewFilter::Exclude || isVersionFilter(filter))
+            {
+                return std::tuple<>();
+            }
+            else if constexpr (filter == EViewFilter::Optional)
+            {
+                const bool hasComponent = pool != nullptr && pool->getOccupancy().test(ECS::getEntityIndex(entityId));
+                return std::tuple<Component*>(hasComponent ? getTypedComponent<Component>(pool, entityId) : nullptr);
+            }
+            else
+            {
+                return std::tuple<Component&>(*getTypedComponent<Component>(pool, entityId));
+            }
+        }
+
+        template<typename ...TComponents>
+        template<typename TComponent>
+        inline TComponent* View<TComponents...>::getTypedComponent(ComponentPool* pool, ECS::EntityId entityId)
+        {
+            if constexpr (isTagComponent<TComponent>())
+            {
+                // tags have no storage, every entity shares the same empty instance.
+                static TComponent tag;
+                return &tag;
+            }
+            else
+            {
+                return static_cast<TComponent*>(getComponent(pool, entityId));
+            }
+        }
+
+        template<typename ...TComponents>
+        inline uint64_t View<TComponents...>::getFilterWord(EViewFilter filter, const ComponentPool* pool, size_t wordIndex)
+        {
+            switch (filter)
+            {
+                case EViewFilter::Required:
+                case EViewFilter::Changed:
+                case EViewFilter::Added:
+                    return pool->getOccupancy().getWord(wordIndex);
+                case EViewFilter::Exclude:
+                    return pool != nullptr ? ~pool->getOccupancy().getWord(wordIndex) : ~uint64_t(0);
+                case EViewFilter::Optional:
+                default:
+                    return ~uint64_t(0);
+            }
+        }
+
+        template<typename ...TComponents>
+        inline void* View<TComponents...>::getComponent(ComponentPool* pool, ECS::EntityId entityId)
+        {
+            if (pool->getStorage() == EComponentStorage::SparseSet)
+            {
+                return static_cast<SparseSetComponentPool*>(pool)->SparseSetComponentPool::get(entityId);
+            }
+            return static_cast<IndexedComponentPool*>(pool)->IndexedComponentPool::get(entityId);
+        }
+
+        template<typename ...TComponents>
+        inline size_t View<TComponents...>::countMatchingEntities() const
+        {
+            size_t matchingEntityCount = 0;
+            for (const Archetype* archetype : m_registry->m_entityContainer.getArchetypes())
+            {
+                if (isMatching(archetype->getSignature(), m_componentMask, m_excludedComponentMask))
+                {
+                    matchingEntityCount += archetype->size();
+                }
+            }
+            return matchingEntityCount;
+        }
+
+        template<typename ...TComponents>
+        inline const SparseSetComponentPool* View<TComponents...>::findDrivingPool(size_t matchingEntityCount) const
+        {
+            const EntityContainer& entityContainer = m_registry->m_entityContainer;
+
+            const SparseSetComponentPool* drivingPool = nullptr;
+            for (size_t i = 0; i < m_componentIds.size(); ++i)
+            {
+                const ComponentPool* pool = entityContainer.getComponentPool(m_componentIds[i]);
+                if (!isRequiredFilter(s_filters[i]) || pool == nullptr || pool->getStorage() != EComponentStorage::SparseSet)
+                {
+                    continue;
+                }
+
+                const SparseSetComponentPool* sparseSetPool = static_cast<const SparseSetComponentPool*>(pool);
+                if (drivingPool == nullptr || sparseSetPool->size() < drivingPool->size())
+                {
+                    drivingPool = sparseSetPool;
+                }
+            }
+
+            if (drivingPool == nullptr)
+            {
+                return nullptr;
+            }
+
+            return drivingPool->size() < matchingEntityCount ? drivingPool : nullptr;
+        }
+
+        template<typename ...TComponents>
+        inline bool View<TComponents...>::collectEntityIds(std::vector<ECS::EntityId>& outEntityIds) const
+        {
+            const size_t matchingEntityCount = countMatchingEntities();
+            const SparseSetComponentPool* drivingPool = findDrivingPool(matchingEntityCount);
+            if (drivingPool != nullptr)
+            {
+                // the pool's entities are filtered when they are visited.
+                outEntityIds.reserve(outEntityIds.size() + drivingPool->size());
+                for (size_t row = 0; row < drivingPool->size(); ++row)
+                {
+                    outEntityIds.push_back(drivingPool->getEntityId(row));
+                }
+                return false;
+            }
+
+            outEntityIds.reserve(outEntityIds.size() + matchingEntityCount);
+            for (const Archetype* archetype : m_registry->m_entityContainer.getArchetypes())
+            {
+                if (!isMatching(archetype->getSignature(), m_componentMask, m_excludedComponentMask))
+                {
+                    continue;
+                }
+
+                for (size_t row = 0; row < archetype->size(); ++row)
+                {
+                    outEntityIds.push_back(archetype->at(row));
+                }
+            }
+            return true;
+        }
+
+        template<typename ...TComponents>
+        inline bool View<TComponents...>::isVisitable(ECS::EntityId entityId, bool isMatchingWhenCollected, uint64_t structuralChangeCount) const
+        {
+            if (isMatchingWhenCollected && m_registry->m_entityContainer.getStructuralChangeCount() == structuralChangeCount)
+            {
+                return isVersionMatching(entityId);
+            }
+
+            const Entity* entity = m_registry->m_entityContainer.getEntity(entityId);
+            return entity != nullptr && isMatching(entity->getSignature(), m_componentMask, m_excludedComponentMask) && isVersionMatching(entityId);
+        }
 
         // ITERATOR BEGIN
         template<typename ...TComponents>
         inline View<TComponents...>::Iterator::Iterator(
-            const Registry* inRegistry,
-            ECS::EntityId inCurrentEntityId,
-            Bitset<ECS::MAX_COMPONENTS> inComponentMask,
-            bool inIsAll
+            const View* inView,
+            std::shared_ptr<const std::vector<ECS::EntityId>> inEntityIds,
+            bool inAreIdsMatching,
+            uint64_t inStructuralChangeCount
         ) :
-            m_currentEntityId(inCurrentEntityId),
-            m_registry(inRegistry),
-            m_size(0),
-            m_componentMask(inComponentMask),
-            m_isAll(inIsAll)
+            m_view(inView),
+            m_entityIds(std::move(inEntityIds)),
+            m_index(0),
+            m_areIdsMatching(inAreIdsMatching),
+            m_structuralChangeCount(inStructuralChangeCount)
         {
-            assert(m_registry != nullptr);
-            m_size = m_registry->unadjustedSize();
+            seekMatchingEntity();
         }
 
         template<typename ...TComponents>
         inline ECS::EntityId View<TComponents...>::Iterator::operator*() const
         {
-            return m_currentEntityId;
+            return (*m_entityIds)[m_index];
         }
     
         template<typename ...TComponents>
         inline bool View<TComponents...>::Iterator::operator==(const Iterator& other) const
         {
-            return m_registry == other.m_registry && 
-                m_size == other.m_size &&
-                m_currentEntityId == other.m_currentEntityId;
+            if (isEnd() || other.isEnd())
+            {
+                return isEnd() == other.isEnd();
+            }
+            return m_entityIds == other.m_entityIds && m_index == other.m_index;
         }
     
         template<typename ...TComponents>
         inline bool View<TComponents...>::Iterator::operator!=(const Iterator& other) const
         {
-            return m_registry != other.m_registry ||
-                m_size != other.m_size ||
-                m_currentEntityId != other.m_currentEntityId;
+            return !(*this == other);
         }
 
         template<typename ...TComponents>
         inline View<TComponents...>::Iterator& View<TComponents...>::Iterator::operator++()
         {
-            for (m_currentEntityId++; m_currentEntityId < m_size; m_currentEntityId++)
-            {
-                if (isValidIndex(m_currentEntityId))
-                {
-                    break; 
-                }
-            }
+            ++m_index;
+            seekMatchingEntity();
             return *this;
         }
 
         template<typename ...TComponents>
-        inline bool View<TComponents...>::Iterator::isValidIndex(const ECS::EntityId id) const
+        inline bool View<TComponents...>::Iterator::isEnd() const
+        {
+            return m_entityIds == nullptr || m_index >= m_entityIds->size();
+        }
+
+        template<typename ...TComponents>
+        inline void View<TComponents...>::Iterator::seekMatchingEntity()
         {
-            if (!m_registry->isValid(id))
+            while (!isEnd() && !m_view->isVisitable((*m_entityIds)[m_index], m_areIdsMatching, m_structuralChangeCount))
             {
-                return false;
+                ++m_index;
             }
-
-            const Entity* entity = m_registry->getEntity(id);
-            return m_isAll || entity->hasComponents(m_componentMask);
         }
         // ITERATOR END
     }
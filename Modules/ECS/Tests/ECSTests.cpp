@@ -1,7 +1,17 @@
 #include <ManiTests/ManiTests.h>
 #include <ECS/Registry.h>
 #include <ECS/View.h>
+#include <ECS/Query.h>
 #include <ECS/Bitset.h>
+#include <ECS/ParallelFor.h>
+#include <ECS/CommandBuffer.h>
+#include <ECS/Hierarchy.h>
+#include <ECS/Snapshot.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <thread>
 
 #ifndef MANI_WEBGL
 extern "C" __declspec(dllexport) void runTests()
@@ -123,8 +133,12 @@ MANI_SECTION_BEGIN(ECS, "ECS")
 		MANI_TEST_ASSERT(dataComponent == nullptr, "Component should be a nullptr.");
 
 		// we expect the entity to be recycled
+		const ECS::EntityId previousEntityId = entityId;
 		entityId = registry.create();
-		MANI_TEST_ASSERT(entityId == 1, "Should be the first entity addded.");
+		MANI_TEST_ASSERT(ECS::getEntityIndex(entityId) == 1, "Should be the first entity addded.");
+		MANI_TEST_ASSERT(entityId != previousEntityId, "A recycled entity should get a new generation.");
+		MANI_TEST_ASSERT(!registry.isValid(previousEntityId), "The id of a destroyed entity should not be valid anymore.");
+		MANI_TEST_ASSERT(registry.get<OtherDataComponent>(previousEntityId) == nullptr, "Components should not be reachable through a stale id.");
 
 		// Entity should not have a DataComponent
 		dataComponent = registry.get<DataComponent>(entityId);
@@ -149,174 +163,1554 @@ MANI_SECTION_BEGIN(ECS, "ECS")
 		MANI_TEST_ASSERT(otherOtherDataComponent->someOtherData == otherDataComponent->someOtherData, "we should be able to mutate a component of a recycled entity.");
 	}
 
+	MANI_TEST(GenerationalEntityIds, "Ids of destroyed entities should never resolve to the entity recycling their index")
+	{
+		struct DataComponent
+		{
+			int someData = 5;
+		};
+
+		ECS::Registry registry;
+
+		const ECS::EntityId firstId = registry.create();
+		registry.add<DataComponent>(firstId)->someData = 1;
+		registry.destroy(firstId);
+
+		const ECS::EntityId secondId = registry.create();
+		registry.add<DataComponent>(secondId)->someData = 2;
+
+		MANI_TEST_ASSERT(ECS::getEntityIndex(firstId) == ECS::getEntityIndex(secondId), "The index should have been recycled.");
+		MANI_TEST_ASSERT(ECS::getEntityGeneration(secondId) == ECS::getEntityGeneration(firstId) + 1, "The generation should have been bumped.");
+		MANI_TEST_ASSERT(!registry.isValid(firstId) && registry.isValid(secondId), "Only the current id should be valid.");
+		MANI_TEST_ASSERT(registry.get<DataComponent>(firstId) == nullptr, "A stale id should not reach the new entity's components.");
+		MANI_TEST_ASSERT(!registry.destroy(firstId), "Destroying a stale id should not destroy the new entity.");
+		MANI_TEST_ASSERT(registry.add<DataComponent>(firstId) == nullptr, "Adding through a stale id should fail.");
+		MANI_TEST_ASSERT(registry.get<DataComponent>(secondId)->someData == 2, "The new entity should be untouched.");
+
+		size_t count = 0;
+		ECS::View<DataComponent>(registry).each([&count, secondId](ECS::EntityId entityId, DataComponent& data)
+		{
+			MANI_TEST_ASSERT(entityId == secondId, "Views should hand out the current id.");
+			count++;
+		});
+		MANI_TEST_ASSERT(count == 1, "Should visit the recycled entity once.");
+	}
+
 	MANI_TEST(CreateRegistryView, "Should create a registry view and iterate through it")
 	{
-		struct DataComponent {
+		struct DataComponent {
+			int someData = 5;
+		};
+
+		struct OtherDataComponent {
+			int someOtherData = 10;
+		};
+
+		// create a registry
+		ECS::Registry registry;
+
+		// create e few entities, all of them with DataComponent, some of them with OtherDataComponent
+		const int entityCount = 10;
+		for (int i = 1; i < entityCount; i++)
+		{
+			const ECS::EntityId entityId = registry.create();
+			registry.add<DataComponent>(entityId);
+			if (i % 2 == 0)
+			{
+				registry.add<OtherDataComponent>(entityId);
+			}
+		}
+
+		MANI_TEST_ASSERT(registry.size() == entityCount, "should have created 10 entities");
+
+		int entityCounter = 1;
+		for (ECS::EntityId entityId : ECS::View<DataComponent, OtherDataComponent>(registry))
+		{
+			entityCounter++;
+
+			auto* component = registry.get<DataComponent>(entityId);
+			MANI_TEST_ASSERT(component != nullptr, "should have a DataComponent");
+
+			auto* otherComponent = registry.get<OtherDataComponent>(entityId);
+			MANI_TEST_ASSERT(otherComponent != nullptr, "should have a OtherDataComponent");
+		}
+		MANI_TEST_ASSERT(entityCounter == entityCount / 2, "There should be 5 entities with DataComponent and OtherDataComponent in the registry view");
+
+		// iterate over the entities with DataComponent
+		entityCounter = 1;
+		for (ECS::EntityId entityId : ECS::View<DataComponent>(registry))
+		{
+			entityCounter++;
+			auto* component = registry.get<DataComponent>(entityId);
+			MANI_TEST_ASSERT(component != nullptr, "should have a DataComponent");
+		}
+		MANI_TEST_ASSERT(entityCounter == entityCount, "There should be 10 entities with DataComponent in the registry view");
+
+		entityCounter = 1;
+		for (ECS::EntityId entityId : ECS::View<OtherDataComponent>(registry))
+		{
+			entityCounter++;
+			auto* otherComponent = registry.get<OtherDataComponent>(entityId);
+			MANI_TEST_ASSERT(otherComponent != nullptr, "should have a OtherDataComponent");
+		}
+		MANI_TEST_ASSERT(entityCounter == entityCount / 2, "There should be 5 entities with OtherDataComponent in the registry view");
+
+
+		entityCounter = 0;
+		for (ECS::EntityId entityId : ECS::View<>(registry))
+		{
+			entityCounter++;
+		}
+		MANI_TEST_ASSERT(entityCounter == 10, "Should iterate over all entities");
+	}
+
+	MANI_TEST(ChaoticEntityCreation, "We should be able to create entities, some without component, and some with components")
+	{
+		struct DataComponent {
+			int someData = 5;
+		};
+
+		// create a registry
+		ECS::Registry registry;
+
+		// create e few entities, all of them with DataComponent, some of them with OtherDataComponent
+		int entityCount = 10;
+		// entity ids start at 1 to leave room for the singleton entity
+		for (int i = 1; i < entityCount; i++)
+		{
+			const ECS::EntityId entityId = registry.create();
+			if (i % 2 == 0)
+			{
+				registry.add<DataComponent>(entityId);
+			}
+		}
+
+		MANI_TEST_ASSERT(registry.size() == entityCount, "should have created 10 entities");
+
+		// iterate over the entities with DataComponent
+		int entityCounter = 1;
+		for (ECS::EntityId entityId : ECS::View<DataComponent>(registry))
+		{
+			entityCounter++;
+			auto* component = registry.get<DataComponent>(entityId);
+			MANI_TEST_ASSERT(component != nullptr, "should have a DataComponent");
+		}
+		MANI_TEST_ASSERT(entityCounter == entityCount / 2, "There should be 5 entities with DataComponent in the registry view");
+	}
+
+	MANI_TEST(ComponentIdAssignation, "ComponentIds should be consecutive")
+	{	
+		struct Component0 {};
+		struct Component1 {};
+		struct Component2 {};
+
+		ECS::Registry registry;
+		const ECS::ComponentId componentId0 = registry.getComponentId<Component0>();
+		const ECS::ComponentId componentId1 = registry.getComponentId<Component1>();
+		const ECS::ComponentId componentId2 = registry.getComponentId<Component2>();
+		
+		MANI_TEST_ASSERT(componentId1 - componentId0 == 1, "The second componentid should follow the first one");
+		MANI_TEST_ASSERT(componentId2 - componentId1 == 1, "The third componentid should follow the second one");
+	}
+
+	MANI_TEST(ComponentIdAcrossRegistries, "A component type should have the same id in every registry")
+	{
+		struct Component0 {};
+		struct Component1 {};
+
+		ECS::Registry registry;
+		ECS::Registry otherRegistry;
+
+		// resolve the ids in a different order in each registry.
+		const ECS::ComponentId componentId0 = registry.getComponentId<Component0>();
+		const ECS::ComponentId otherComponentId1 = otherRegistry.getComponentId<Component1>();
+		const ECS::ComponentId otherComponentId0 = otherRegistry.getComponentId<Component0>();
+		const ECS::ComponentId componentId1 = registry.getComponentId<Component1>();
+
+		MANI_TEST_ASSERT(componentId0 == otherComponentId0, "Component0 should have the same id in both registries");
+		MANI_TEST_ASSERT(componentId1 == otherComponentId1, "Component1 should have the same id in both registries");
+		MANI_TEST_ASSERT(componentId0 != componentId1, "Different components should have different ids");
+	}
+
+	MANI_TEST(ComponentIdSharedName, "Component types sharing a name should get different ids, other modules should match them by name")
+	{
+		struct SmallComponent
+		{
+			int value = 0;
+		};
+
+		struct LargeComponent
+		{
+			double values[4] = {};
+		};
+
+		// the descriptions of two types named alike, as types of anonymous namespaces in different translation units.
+		const ECS::ComponentInfo& smallComponentInfo = ECS::getComponentInfo<SmallComponent>();
+		const ECS::ComponentInfo& largeComponentInfo = ECS::getComponentInfo<LargeComponent>();
+		const ECS::ComponentInfo otherModuleComponentInfo = smallComponentInfo;
+
+		ECS::ComponentTypeRegistry componentTypeRegistry;
+		const ECS::ComponentId smallComponentId = componentTypeRegistry.getComponentId(smallComponentInfo, "Component");
+		const ECS::ComponentId largeComponentId = componentTypeRegistry.getComponentId(largeComponentInfo, "Component");
+		MANI_TEST_ASSERT(smallComponentId != largeComponentId, "Types sharing a name should have different ids");
+		MANI_TEST_ASSERT(componentTypeRegistry.getComponentId(smallComponentInfo, "Component") == smallComponentId, "A type should keep its id");
+		MANI_TEST_ASSERT(componentTypeRegistry.getComponentInfo(smallComponentId) == &smallComponentInfo, "The first type's description should not be overwritten");
+
+		const ECS::ComponentId otherModuleComponentId = componentTypeRegistry.getComponentId("Component", &otherModuleComponentInfo);
+		MANI_TEST_ASSERT(otherModuleComponentId == smallComponentId, "Another module should match the type by name and layout");
+		MANI_TEST_ASSERT(componentTypeRegistry.getComponentInfo(smallComponentId) == &smallComponentInfo, "Another module should not overwrite the type's description");
+	}
+
+	MANI_TEST(Spawn1000000Entities, "Should spawn 1'000'000 entities with a transform")
+	{
+		struct Transform
+		{
+			float position[3];
+			float rotation[3];
+			float scale[3];
+		};
+
+		ECS::Registry registry;
+		for (int i = 1; i < 1'000'000; ++i)
+		{
+			const ECS::EntityId entityId = registry.create();
+			Transform* transform = registry.add<Transform>(entityId);
+			transform->position[0] = 1.f;
+			transform->position[1] = 1.f;
+			transform->position[2] = 1.f;
+
+			transform->rotation[0] = 1.f;
+			transform->rotation[1] = 1.f;
+			transform->rotation[2] = 1.f;
+
+			transform->scale[0] = 1.f;
+			transform->scale[1] = 1.f;
+			transform->scale[2] = 1.f;
+		}
+
+		MANI_TEST_ASSERT(registry.size() == 1'000'000, "Should have spawned 1'000'000 entities.");
+	}
+
+	MANI_TEST(PlayWithDynamicAllocation, "Should allow dynamic allocation")
+	{
+		struct DynamicComponent
+		{
+			std::vector<float> vector = { 1.f, 2.f, 3.f };
+		};
+
+		ECS::Registry registry;
+		const ECS::EntityId entity1 = registry.create();
+		const ECS::EntityId entity2 = registry.create();
+
+		DynamicComponent* component1 = registry.add<DynamicComponent>(entity1);
+		DynamicComponent* component2 = registry.add<DynamicComponent>(entity2);
+		for (int i = 0; i < 1000; ++i)
+		{
+			component1->vector.push_back(i + 1 * 1000.f);
+		}
+
+		MANI_TEST_ASSERT(component2->vector[0] - 1.f <= 1.192092896e-07F, "first vector element should be equal to the original value");
+		MANI_TEST_ASSERT(component2->vector[1] - 2.f <= 1.192092896e-07F, "second vector element should be equal to the original value");
+		MANI_TEST_ASSERT(component2->vector[2] - 3.f <= 1.192092896e-07F, "third vector element should be equal to the original value");
+	}
+
+	MANI_TEST(ViewEach, "Should iterate over the view's components by reference")
+	{
+		struct DataComponent
+		{
+			int someData = 5;
+		};
+
+		struct OtherDataComponent
+		{
+			int someOtherData = 10;
+		};
+
+		ECS::Registry registry;
+
+		for (int i = 0; i < 10; ++i)
+		{
+			const ECS::EntityId entityId = registry.create();
+			registry.add<DataComponent>(entityId);
+			if (i % 2 == 0)
+			{
+				registry.add<OtherDataComponent>(entityId);
+			}
+		}
+
+		int count = 0;
+		ECS::View<DataComponent, OtherDataComponent>(registry).each([&count](ECS::EntityId entityId, DataComponent& data, OtherDataComponent& otherData)
+		{
+			data.someData += otherData.someOtherData;
+			count++;
+		});
+		MANI_TEST_ASSERT(count == 5, "Should visit the 5 entities with both components");
+
+		int total = 0;
+		ECS::View<DataComponent>(registry).each([&registry, &total](ECS::EntityId entityId, const DataComponent& data)
+		{
+			MANI_TEST_ASSERT(registry.get<DataComponent>(entityId) == &data, "Should hand out the entity's component");
+			total += data.someData;
+		});
+		MANI_TEST_ASSERT(total == 10 * 5 + 5 * 10, "Components should have been edited through the references");
+
+		struct NeverAddedComponent {};
+		count = 0;
+		ECS::View<DataComponent, NeverAddedComponent>(registry).each([&count](ECS::EntityId entityId, DataComponent& data, NeverAddedComponent& neverAdded)
+		{
+			count++;
+		});
+		MANI_TEST_ASSERT(count == 0, "Should not visit anything when a component was never added");
+	}
+
+	MANI_TEST(ViewEachBitmapScan, "Dense views should scan the occupancy bitmaps and skip entities removed during the iteration")
+	{
+		struct DataComponent
+		{
+			int someData = 5;
+		};
+
+		struct OtherDataComponent
+		{
+			int someOtherData = 10;
+		};
+
+		ECS::Registry registry;
+
+		std::vector<ECS::EntityId> entityIds;
+		for (int i = 0; i < 200; ++i)
+		{
+			const ECS::EntityId entityId = registry.create();
+			registry.add<DataComponent>(entityId);
+			if (i % 3 == 0)
+			{
+				registry.add<OtherDataComponent>(entityId);
+			}
+			entityIds.push_back(entityId);
+		}
+
+		// destroys the next entity and removes a component from the one after, neither should be visited.
+		std::vector<ECS::EntityId> visitedIds;
+		ECS::View<DataComponent>(registry).each([&registry, &visitedIds](ECS::EntityId entityId, DataComponent& data)
+		{
+			visitedIds.push_back(entityId);
+			if (visitedIds.size() % 3 == 1)
+			{
+				registry.destroy(entityId + 1);
+				registry.remove<DataComponent>(entityId + 2);
+			}
+		});
+
+		MANI_TEST_ASSERT(std::is_sorted(visitedIds.begin(), visitedIds.end()), "Dense views should be visited in ascending id order");
+		for (const ECS::EntityId entityId : visitedIds)
+		{
+			MANI_TEST_ASSERT(registry.has<DataComponent>(entityId), "Should not visit removed components or destroyed entities");
+		}
+
+		size_t expectedCount = 0;
+		for (const ECS::EntityId entityId : ECS::View<DataComponent>(registry))
+		{
+			expectedCount++;
+		}
+		MANI_TEST_ASSERT(visitedIds.size() == expectedCount, "Should visit every entity left with a DataComponent");
+
+		// a few matches in a large registry are walked through their archetype.
+		for (int i = 0; i < 10'000; ++i)
+		{
+			registry.create();
+		}
+
+		size_t count = 0;
+		ECS::View<DataComponent, OtherDataComponent>(registry).each([&count](ECS::EntityId entityId, DataComponent& data, OtherDataComponent& otherData)
+		{
+			count++;
+		});
+
+		size_t otherCount = 0;
+		for (const ECS::EntityId entityId : ECS::View<DataComponent, OtherDataComponent>(registry))
+		{
+			otherCount++;
+		}
+		MANI_TEST_ASSERT(count == otherCount, "Sparse views should visit the same entities as the iterator");
+	}
+
+	MANI_TEST(SparseViewStructuralChanges, "Sparse views should visit each entity once when the function destroys or moves other entities")
+	{
+		struct DataComponent
+		{
+			int someData = 5;
+		};
+
+		struct OtherDataComponent
+		{
+			int someData = 5;
+		};
+
+		ECS::Registry registry;
+		std::vector<ECS::EntityId> entityIds;
+		registry.createMany(10, entityIds);
+		registry.emplaceMany<DataComponent>(entityIds);
+		std::vector<ECS::EntityId> emptyEntityIds;
+		registry.createMany(100'000, emptyEntityIds);
+
+		// the first entity of the archetype is destroyed and the second one leaves it on the first visit.
+		std::vector<ECS::EntityId> visitedIds;
+		ECS::View<DataComponent>(registry).each([&registry, &entityIds, &visitedIds](ECS::EntityId entityId, DataComponent& data)
+		{
+			if (visitedIds.empty())
+			{
+				registry.destroy(entityIds[0]);
+				registry.remove<DataComponent>(entityIds[1]);
+			}
+			visitedIds.push_back(entityId);
+		});
+
+		std::sort(visitedIds.begin(), visitedIds.end());
+		MANI_TEST_ASSERT(std::adjacent_find(visitedIds.begin(), visitedIds.end()) == visitedIds.end(), "No entity should be visited twice");
+		MANI_TEST_ASSERT(visitedIds.size() == 8 || visitedIds.size() == 9, "Every entity left in the view should be visited");
+		for (size_t i = 2; i < entityIds.size(); ++i)
+		{
+			MANI_TEST_ASSERT(std::binary_search(visitedIds.begin(), visitedIds.end(), entityIds[i]), "Entities left in the view should be visited");
+		}
+
+		// the iterator walks the same snapshot, adding components moves the entities to another archetype.
+		visitedIds.clear();
+		for (const ECS::EntityId entityId : ECS::View<DataComponent>(registry))
+		{
+			visitedIds.push_back(entityId);
+			registry.add<OtherDataComponent>(entityIds[2 + visitedIds.size() % 8]);
+		}
+		std::sort(visitedIds.begin(), visitedIds.end());
+		MANI_TEST_ASSERT(visitedIds.size() == 8 && std::adjacent_find(visitedIds.begin(), visitedIds.end()) == visitedIds.end(), "The iterator should visit each entity once");
+	}
+
+	MANI_TEST(ViewFilters, "Should skip excluded components and hand out optional components as pointers")
+	{
+		struct DataComponent
+		{
+			int someData = 5;
+		};
+
+		struct HiddenComponent {};
+
+		struct OptionalComponent
+		{
+			int someOptionalData = 10;
+		};
+
+		ECS::Registry registry;
+		for (int i = 0; i < 100; ++i)
+		{
+			const ECS::EntityId entityId = registry.create();
+			registry.add<DataComponent>(entityId);
+			if (i % 2 == 0)
+			{
+				registry.add<HiddenComponent>(entityId);
+			}
+			if (i % 5 == 0)
+			{
+				registry.add<OptionalComponent>(entityId);
+			}
+		}
+
+		using FilteredView = ECS::View<DataComponent, ECS::Exclude<HiddenComponent>, ECS::Optional<OptionalComponent>>;
+
+		size_t iteratorCount = 0;
+		for (const ECS::EntityId entityId : FilteredView(registry))
+		{
+			MANI_TEST_ASSERT(!registry.has<HiddenComponent>(entityId), "The iterator should skip excluded components");
+			iteratorCount++;
+		}
+		MANI_TEST_ASSERT(iteratorCount == 50, "The iterator should visit the 50 visible entities");
+
+		auto checkEach = [&registry](const FilteredView& view, size_t expectedCount, size_t expectedOptionalCount)
+		{
+			size_t count = 0;
+			size_t optionalCount = 0;
+			view.each([&registry, &count, &optionalCount](ECS::EntityId entityId, DataComponent& data, OptionalComponent* optional)
+			{
+				MANI_TEST_ASSERT(!registry.has<HiddenComponent>(entityId), "each should skip excluded components");
+				MANI_TEST_ASSERT(optional == registry.get<OptionalComponent>(entityId), "Optional components should be handed out when present");
+				count++;
+				optionalCount += optional != nullptr ? 1 : 0;
+			});
+			MANI_TEST_ASSERT(count == expectedCount, "each should visit the visible entities");
+			MANI_TEST_ASSERT(optionalCount == expectedOptionalCount, "each should hand out the optional components");
+		};
+
+		// dense, the occupancy bitmaps are scanned.
+		checkEach(FilteredView(registry), 50, 10);
+
+		// sparse, the archetypes are walked.
+		for (int i = 0; i < 10'000; ++i)
+		{
+			registry.create();
+		}
+		checkEach(FilteredView(registry), 50, 10);
+
+		std::atomic<size_t> parallelCount = 0;
+		FilteredView(registry).parallelEach([&parallelCount](ECS::EntityId entityId, DataComponent& data, OptionalComponent* optional)
+		{
+			parallelCount++;
+		}, 16);
+		MANI_TEST_ASSERT(parallelCount == 50, "parallelEach should skip excluded components");
+
+		struct NeverAddedComponent {};
+		size_t count = 0;
+		ECS::View<DataComponent, ECS::Exclude<NeverAddedComponent>, ECS::Optional<NeverAddedComponent>>(registry).each([&count](ECS::EntityId entityId, DataComponent& data, NeverAddedComponent* neverAdded)
+		{
+			count += neverAdded == nullptr ? 1 : 0;
+		});
+		MANI_TEST_ASSERT(count == 100, "Filters on components that were never added should not restrict the view");
+	}
+
+	MANI_TEST(PersistentQueries, "Queries should follow the entities entering and leaving them without rescanning the registry")
+	{
+		struct DataComponent
+		{
+			int someData = 5;
+		};
+
+		struct HiddenComponent {};
+
+		ECS::Registry registry;
+		std::vector<ECS::EntityId> entityIds;
+		for (int i = 0; i < 10; ++i)
+		{
+			const ECS::EntityId entityId = registry.create();
+			registry.add<DataComponent>(entityId)->someData = i;
+			entityIds.push_back(entityId);
+		}
+
+		// built after the entities, the query picks up the existing ones.
+		ECS::Query<DataComponent, ECS::Exclude<HiddenComponent>> query(registry);
+		MANI_TEST_ASSERT(query.size() == 10, "The query should hold the existing matching entities");
+
+		registry.add<HiddenComponent>(entityIds[0]);
+		registry.add<HiddenComponent>(entityIds[1]);
+		registry.remove<DataComponent>(entityIds[2]);
+		registry.destroy(entityIds[3]);
+		MANI_TEST_ASSERT(query.size() == 6, "Entities leaving the query should be removed from it");
+
+		registry.remove<HiddenComponent>(entityIds[1]);
+		const ECS::EntityId newEntityId = registry.create();
+		registry.add<DataComponent>(newEntityId)->someData = 42;
+		MANI_TEST_ASSERT(query.size() == 8, "Entities entering the query should be added to it");
+
+		ECS::Query<DataComponent, ECS::Exclude<HiddenComponent>> sameQuery(registry);
+		MANI_TEST_ASSERT(sameQuery.size() == 8, "Queries with the same components should share their state");
+
+		int sum = 0;
+		size_t count = 0;
+		query.each([&registry, &sum, &count](ECS::EntityId entityId, DataComponent& data)
+		{
+			MANI_TEST_ASSERT(registry.isValid(entityId), "each should only visit alive entities");
+			MANI_TEST_ASSERT(!registry.has<HiddenComponent>(entityId), "each should skip excluded components");
+			MANI_TEST_ASSERT(&data == registry.get<DataComponent>(entityId), "each should hand out the entity's component");
+			sum += data.someData;
+			count++;
+		});
+		MANI_TEST_ASSERT(count == 8, "each should visit every entity of the query");
+		MANI_TEST_ASSERT(sum == 1 + 4 + 5 + 6 + 7 + 8 + 9 + 42, "each should visit every entity of the query once");
+
+		count = 0;
+		query.each([&registry, &count](ECS::EntityId entityId, DataComponent& data)
+		{
+			// removing the current entity and another one must not skip nor repeat entities.
+			if (data.someData == 42)
+			{
+				registry.destroy(entityId);
+				registry.add<HiddenComponent>(registry.create());
+			}
+			if (data.someData == 9)
+			{
+				registry.add<HiddenComponent>(entityId);
+			}
+			count++;
+		});
+		MANI_TEST_ASSERT(count == 8, "each should allow removing entities from the query during the iteration");
+		MANI_TEST_ASSERT(query.size() == 6, "The query should be up to date after the iteration");
+
+		struct NeverAddedComponent {};
+		ECS::Query<NeverAddedComponent> emptyQuery(registry);
+		count = 0;
+		emptyQuery.each([&count](ECS::EntityId entityId, NeverAddedComponent& neverAdded)
+		{
+			count++;
+		});
+		MANI_TEST_ASSERT(count == 0 && emptyQuery.size() == 0, "A query on a component that was never added should be empty");
+
+		const ECS::EntityId lateEntityId = registry.create();
+		registry.add<NeverAddedComponent>(lateEntityId);
+		MANI_TEST_ASSERT(emptyQuery.size() == 1, "Queries should follow archetypes created after them");
+	}
+
+	struct SparseDataComponent
+	{
+		static constexpr ECS::EComponentStorage storage = ECS::EComponentStorage::SparseSet;
+		int someData = 0;
+	};
+
+	MANI_TEST(ChangeTracking, "Changed and Added views should only visit the components stamped after their version")
+	{
+		struct DataComponent
+		{
+			int someData = 5;
+		};
+
+		ECS::Registry registry;
+		std::vector<ECS::EntityId> entityIds;
+		for (int i = 0; i < 100; ++i)
+		{
+			const ECS::EntityId entityId = registry.create();
+			registry.add<DataComponent>(entityId);
+			entityIds.push_back(entityId);
+		}
+
+		auto countEntities = [](const auto& view)
+		{
+			size_t count = 0;
+			view.each([&count](ECS::EntityId entityId, DataComponent& data)
+			{
+				count++;
+			});
+
+			size_t iteratorCount = 0;
+			for (const ECS::EntityId entityId : view)
+			{
+				iteratorCount++;
+			}
+			MANI_TEST_ASSERT(count == iteratorCount, "each and the iterator should visit the same entities");
+
+			std::atomic<size_t> parallelCount = 0;
+			view.parallelEach([&parallelCount](ECS::EntityId entityId, DataComponent& data)
+			{
+				parallelCount++;
+			}, 16);
+			MANI_TEST_ASSERT(count == parallelCount, "each and parallelEach should visit the same entities");
+			return count;
+		};
+
+		using ChangedView = ECS::View<DataComponent, ECS::Changed<DataComponent>>;
+		using AddedView = ECS::View<DataComponent, ECS::Added<DataComponent>>;
+
+		MANI_TEST_ASSERT(countEntities(ChangedView(registry)) == 100, "Added components should be changed since version 0");
+		const uint32_t version = registry.advanceChangeVersion();
+		MANI_TEST_ASSERT(registry.getChangeVersion() == version + 1, "advanceChangeVersion should move to the next version");
+		MANI_TEST_ASSERT(countEntities(ChangedView(registry, version)) == 0, "Nothing changed since the version was advanced");
+
+		registry.getMut<DataComponent>(entityIds[10])->someData = 10;
+		registry.markChanged<DataComponent>(entityIds[20]);
+		registry.get<DataComponent>(entityIds[30])->someData = 30;
+		MANI_TEST_ASSERT(countEntities(ChangedView(registry, version)) == 2, "getMut and markChanged should mark the component changed");
+		MANI_TEST_ASSERT(countEntities(AddedView(registry, version)) == 0, "Changing a component should not mark it added");
+
+		const ECS::EntityId newEntityId = registry.create();
+		registry.add<DataComponent>(newEntityId);
+		MANI_TEST_ASSERT(countEntities(AddedView(registry, version)) == 1, "New components should be added since the version");
+		MANI_TEST_ASSERT(countEntities(ChangedView(registry, version)) == 3, "New components should be changed since the version");
+
+		const uint32_t nextVersion = registry.advanceChangeVersion();
+		MANI_TEST_ASSERT(countEntities(ChangedView(registry, nextVersion)) == 0, "Changes stamped before the version should not be visited");
+
+		// dense views scan the occupancy bitmaps, the filters apply there too.
+		for (const ECS::EntityId entityId : entityIds)
+		{
+			registry.markChanged<DataComponent>(entityId);
+		}
+		MANI_TEST_ASSERT(countEntities(ChangedView(registry, nextVersion)) == 100, "Every marked component should be visited");
+
+		ECS::Query<DataComponent, ECS::Changed<DataComponent>> query(registry, nextVersion);
+		registry.getMut<DataComponent>(newEntityId);
+		size_t queryCount = 0;
+		query.each([&queryCount](ECS::EntityId entityId, DataComponent& data)
+		{
+			queryCount++;
+		});
+		MANI_TEST_ASSERT(queryCount == 101, "Queries should apply the Changed filter");
+		query.setSinceVersion(registry.advanceChangeVersion());
+		queryCount = 0;
+		query.each([&queryCount](ECS::EntityId entityId, DataComponent& data)
+		{
+			queryCount++;
+		});
+		MANI_TEST_ASSERT(queryCount == 0, "Queries should follow their since version");
+
+		// sparse set pools drive the view when they hold fewer components than the matching archetypes.
+		const uint32_t sparseVersion = registry.advanceChangeVersion();
+		registry.add<SparseDataComponent>(entityIds[0]);
+		registry.add<SparseDataComponent>(entityIds[1]);
+		registry.add<SparseDataComponent>(entityIds[2]);
+		size_t sparseCount = 0;
+		ECS::View<DataComponent, ECS::Added<SparseDataComponent>>(registry, sparseVersion).each([&sparseCount](ECS::EntityId entityId, DataComponent& data)
+		{
+			sparseCount++;
+		});
+		MANI_TEST_ASSERT(sparseCount == 3, "Added filters should apply to sparse set components");
+
+		MANI_TEST_ASSERT(registry.getMut<SparseDataComponent>(entityIds[50]) == nullptr, "getMut should return nullptr for missing components");
+		MANI_TEST_ASSERT(!registry.markChanged<SparseDataComponent>(entityIds[50]), "markChanged should fail for missing components");
+	}
+
+	MANI_TEST(SparseSetChangeVersions, "Sparse set pools should keep their change versions next to their components")
+	{
+		// a component on a far entity index should not pay for the indices before it.
+		ECS::SparseSetComponentPool pool(ECS::getComponentInfo<SparseDataComponent>());
+		const ECS::EntityId farEntityId = ECS::makeEntityId(1000000, 0);
+		const ECS::EntityId nearEntityId = ECS::makeEntityId(10, 0);
+		new (pool.add(farEntityId)) SparseDataComponent();
+		pool.markAdded(ECS::getEntityIndex(farEntityId), 3);
+		new (pool.add(nearEntityId)) SparseDataComponent();
+		pool.markAdded(ECS::getEntityIndex(nearEntityId), 5);
+		MANI_TEST_ASSERT(pool.getVersionCount() == 2, "Versions should only be stored for the pool's components");
+
+		// the last component and its versions move in the freed slot.
+		pool.remove(farEntityId);
+		MANI_TEST_ASSERT(pool.getVersionCount() == 1, "Removing a component should release its versions");
+		MANI_TEST_ASSERT(pool.getAddedVersion(ECS::getEntityIndex(nearEntityId)) == 5, "Moved components should keep their versions");
+
+		ECS::Registry registry;
+		std::vector<ECS::EntityId> entityIds;
+		registry.createMany(3, entityIds);
+		for (const ECS::EntityId entityId : entityIds)
+		{
+			registry.add<SparseDataComponent>(entityId);
+		}
+
+		const uint32_t version = registry.advanceChangeVersion();
+		registry.markChanged<SparseDataComponent>(entityIds[2]);
+		registry.remove<SparseDataComponent>(entityIds[0]);
+
+		std::vector<ECS::EntityId> changedEntityIds;
+		ECS::View<ECS::Changed<SparseDataComponent>>(registry, version).each([&changedEntityIds](ECS::EntityId entityId)
+		{
+			changedEntityIds.push_back(entityId);
+		});
+		MANI_TEST_ASSERT(changedEntityIds.size() == 1 && changedEntityIds[0] == entityIds[2], "Versions should follow their component when the pool is compacted");
+	}
+
+	MANI_TEST(ParallelEach, "Should visit every entity of the view exactly once with parallelEach")
+	{
+		struct Velocity
+		{
+			float x = 0.f;
+		};
+
+		struct SerialPosition
+		{
+			float x = 0.f;
+		};
+
+		struct ParallelPosition
+		{
+			float x = 0.f;
+		};
+
+		// the default parallel for runs on the calling thread, spread the batches over a few threads instead.
+		ECS::setParallelFor([](size_t batchCount, const std::function<void(size_t)>& function)
+		{
+			std::atomic<size_t> nextBatchIndex = 0;
+			auto work = [&nextBatchIndex, batchCount, &function]()
+			{
+				for (size_t batchIndex = nextBatchIndex++; batchIndex < batchCount; batchIndex = nextBatchIndex++)
+				{
+					function(batchIndex);
+				}
+			};
+
+			std::vector<std::thread> threads;
+			for (int i = 0; i < 3; ++i)
+			{
+				threads.emplace_back(work);
+			}
+			work();
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+		});
+
+		for (const size_t entityCount : { 10'000, 100'000, 1'000'000 })
+		{
+			ECS::Registry registry;
+			for (size_t i = 0; i < entityCount; ++i)
+			{
+				const ECS::EntityId entityId = registry.create();
+				registry.add<SerialPosition>(entityId);
+				registry.add<ParallelPosition>(entityId);
+				if (i % 4 != 0)
+				{
+					registry.add<Velocity>(entityId)->x = static_cast<float>(i % 7);
+				}
+			}
+
+			ECS::View<SerialPosition, Velocity>(registry).each([](ECS::EntityId entityId, SerialPosition& position, const Velocity& velocity)
+			{
+				position.x += velocity.x * 0.5f;
+			});
+
+			std::atomic<size_t> visitCount = 0;
+			ECS::View<ParallelPosition, Velocity>(registry).parallelEach([&visitCount](ECS::EntityId entityId, ParallelPosition& position, const Velocity& velocity)
+			{
+				position.x += velocity.x * 0.5f;
+				visitCount++;
+			}, 256);
+
+			MANI_TEST_ASSERT(visitCount == entityCount - entityCount / 4, "Should visit every entity with a velocity once");
+
+			bool areResultsEqual = true;
+			ECS::View<SerialPosition, ParallelPosition>(registry).each([&areResultsEqual](ECS::EntityId entityId, const SerialPosition& serial, const ParallelPosition& parallel)
+			{
+				areResultsEqual &= serial.x == parallel.x;
+			});
+			MANI_TEST_ASSERT(areResultsEqual, "parallelEach should produce the same components as each");
+		}
+		ECS::setParallelFor(nullptr);
+	}
+
+	MANI_TEST(ParallelEachModes, "parallelEach should cut batches by grain size and be reproducible in deterministic mode")
+	{
+		struct DataComponent
+		{
+			int someData = 5;
+		};
+
+		ECS::Registry registry;
+		for (int i = 0; i < 1000; ++i)
+		{
+			registry.add<DataComponent>(registry.create());
+		}
+
+		ECS::View<DataComponent> view(registry);
+
+		std::vector<ECS::EntityId> firstOrder;
+		view.parallelEach([&firstOrder](ECS::EntityId entityId, DataComponent& data)
+		{
+			firstOrder.push_back(entityId);
+		}, 100, ECS::EParallelMode::Deterministic);
+
+		std::vector<ECS::EntityId> secondOrder;
+		view.parallelEach([&secondOrder](ECS::EntityId entityId, DataComponent& data)
+		{
+			secondOrder.push_back(entityId);
+		}, 100, ECS::EParallelMode::Deterministic);
+
+		MANI_TEST_ASSERT(firstOrder.size() == 1000, "Should visit every entity in deterministic mode");
+		MANI_TEST_ASSERT(firstOrder == secondOrder, "Deterministic mode should always visit entities in the same order");
+
+		size_t dispatchedBatchCount = 0;
+		ECS::setParallelFor([&dispatchedBatchCount](size_t batchCount, const std::function<void(size_t)>& function)
+		{
+			dispatchedBatchCount = batchCount;
+			for (size_t batchIndex = 0; batchIndex < batchCount; ++batchIndex)
+			{
+				function(batchIndex);
+			}
+		});
+
+		int count = 0;
+		view.parallelEach([&count](ECS::EntityId entityId, DataComponent& data)
+		{
+			count++;
+		}, 300);
+		ECS::setParallelFor(nullptr);
+
+		MANI_TEST_ASSERT(dispatchedBatchCount == 4, "1000 entities should be split in 4 batches of at most 300 entities");
+		MANI_TEST_ASSERT(count == 1000, "Should visit every entity through the custom parallel for");
+	}
+
+	MANI_TEST(CommandBuffer, "Should record structural changes during an iteration and apply them on flush")
+	{
+		struct DataComponent
+		{
+			int someData = 5;
+		};
+
+		struct OtherDataComponent
+		{
+			std::vector<int> values;
+		};
+
+		ECS::Registry registry;
+		for (int i = 0; i < 100; ++i)
+		{
+			registry.add<DataComponent>(registry.create())->someData = i;
+		}
+
+		size_t createdCount = 0;
+		registry.onEntitiesCreated.subscribe([&createdCount](ECS::Registry& registry, std::span<const ECS::EntityId> entityIds)
+		{
+			createdCount += entityIds.size();
+		});
+
+		// every visited entity spawns a child and odd entities are destroyed.
+		ECS::CommandBuffer commandBuffer;
+		size_t visitCount = 0;
+		ECS::View<DataComponent>(registry).each([&commandBuffer, &visitCount](ECS::EntityId entityId, DataComponent& data)
+		{
+			const ECS::EntityId childId = commandBuffer.create();
+			MANI_TEST_ASSERT(ECS::CommandBuffer::isPending(childId), "Recorded entities should get a pending id");
+			commandBuffer.add<OtherDataComponent>(childId, OtherDataComponent{ { data.someData } });
+			if (data.someData % 2 == 1)
+			{
+				commandBuffer.destroy(entityId);
+			}
+			visitCount++;
+		});
+
+		MANI_TEST_ASSERT(visitCount == 100, "Recording should not change the iterated entities");
+		MANI_TEST_ASSERT(registry.size() == 101 && createdCount == 0, "Nothing should be applied before the flush");
+		MANI_TEST_ASSERT(!commandBuffer.isEmpty(), "The buffer should hold the recorded commands");
+
+		commandBuffer.flush(registry);
+
+		MANI_TEST_ASSERT(commandBuffer.isEmpty(), "The buffer should be empty after a flush");
+		MANI_TEST_ASSERT(createdCount == 100, "Creations should broadcast their events on flush");
+		MANI_TEST_ASSERT(registry.size() == 101 + 100 - 50, "Should have created the children and destroyed the odd entities");
+
+		int childCount = 0;
+		int valueSum = 0;
+		ECS::View<OtherDataComponent>(registry).each([&childCount, &valueSum](ECS::EntityId entityId, OtherDataComponent& otherData)
+		{
+			childCount++;
+			valueSum += otherData.values.size() == 1 ? otherData.values[0] : -1000;
+		});
+		MANI_TEST_ASSERT(childCount == 100 && valueSum == 99 * 100 / 2, "Recorded components should be moved to the created entities");
+
+		// removals recorded from worker threads are applied in one go.
+		ECS::View<OtherDataComponent>(registry).parallelEach([&commandBuffer](ECS::EntityId entityId, OtherDataComponent& otherData)
+		{
+			commandBuffer.remove<OtherDataComponent>(entityId);
+		}, 8);
+		commandBuffer.flush(registry);
+
+		childCount = 0;
+		for (const ECS::EntityId entityId : ECS::View<OtherDataComponent>(registry))
+		{
+			childCount++;
+		}
+		MANI_TEST_ASSERT(childCount == 0, "Removals recorded from workers should have been applied");
+	}
+
+	MANI_TEST(CommandBufferBatching, "Consecutive commands of a kind should be applied in bulk on flush")
+	{
+		struct DataComponent
+		{
+			int someData = 0;
+		};
+
+		ECS::Registry registry;
+
+		size_t createdBroadcastCount = 0;
+		size_t addedBroadcastCount = 0;
+		size_t destroyedBroadcastCount = 0;
+		registry.onEntitiesCreated.subscribe([&createdBroadcastCount](ECS::Registry& registry, std::span<const ECS::EntityId> entityIds)
+		{
+			createdBroadcastCount++;
+		});
+		registry.onComponentsAdded.subscribe([&addedBroadcastCount](ECS::Registry& registry, std::span<const ECS::EntityId> entityIds, ECS::ComponentId componentId)
+		{
+			addedBroadcastCount++;
+		});
+		registry.onEntitiesDestroyed.subscribe([&destroyedBroadcastCount](ECS::Registry& registry, std::span<const ECS::EntityId> entityIds)
+		{
+			destroyedBroadcastCount++;
+		});
+
+		ECS::CommandBuffer commandBuffer;
+		std::vector<ECS::EntityId> pendingIds;
+		for (int i = 0; i < 10; ++i)
+		{
+			pendingIds.push_back(commandBuffer.create());
+		}
+		for (int i = 0; i < 10; ++i)
+		{
+			commandBuffer.add<DataComponent>(pendingIds[i], DataComponent{ i });
+		}
+		// an entity recorded twice keeps its first component.
+		commandBuffer.add<DataComponent>(pendingIds[0], DataComponent{ 100 });
+		for (int i = 1; i < 10; i += 2)
+		{
+			commandBuffer.destroy(pendingIds[i]);
+		}
+
+		commandBuffer.flush(registry);
+
+		MANI_TEST_ASSERT(createdBroadcastCount == 1 && addedBroadcastCount == 1 && destroyedBroadcastCount == 1, "Each run of commands should broadcast one bulk event");
+		MANI_TEST_ASSERT(registry.size() == 1 + 5, "Should have created 10 entities and destroyed 5 of them");
+
+		int valueSum = 0;
+		ECS::View<DataComponent>(registry).each([&valueSum](ECS::EntityId entityId, DataComponent& data)
+		{
+			valueSum += data.someData;
+		});
+		MANI_TEST_ASSERT(valueSum == 0 + 2 + 4 + 6 + 8, "Recorded components should be moved to the created entities");
+	}
+
+	MANI_TEST(CommandBufferDiscard, "Commands that are never flushed should release their components")
+	{
+		struct OtherDataComponent
+		{
+			std::vector<int> values;
+		};
+
+		ECS::Registry registry;
+		{
+			ECS::CommandBuffer commandBuffer;
+			const ECS::EntityId entityId = commandBuffer.create();
+			commandBuffer.add<OtherDataComponent>(entityId, OtherDataComponent{ std::vector<int>(1000, 1) });
+		}
+		MANI_TEST_ASSERT(registry.size() == 1, "An unflushed buffer should not touch the registry");
+	}
+
+	MANI_TEST(BulkOperations, "Should create, emplace and destroy entities in bulk with batched events")
+	{
+		struct DataComponent
+		{
+			int someData = 5;
+		};
+
+		struct OtherDataComponent
+		{
+			int someOtherData = 10;
+		};
+
+		ECS::Registry registry;
+
+		size_t createdEventCount = 0;
+		size_t createdEntityCount = 0;
+		registry.onEntitiesCreated.subscribe([&createdEventCount, &createdEntityCount](ECS::Registry& registry, std::span<const ECS::EntityId> entityIds)
+		{
+			createdEventCount++;
+			createdEntityCount += entityIds.size();
+		});
+
+		size_t addedEventCount = 0;
+		registry.onComponentsAdded.subscribe([&addedEventCount](ECS::Registry& registry, std::span<const ECS::EntityId> entityIds, ECS::ComponentId componentId)
+		{
+			addedEventCount++;
+		});
+
+		size_t destroyedEntityCount = 0;
+		registry.onEntitiesDestroyed.subscribe([&destroyedEntityCount](ECS::Registry& registry, std::span<const ECS::EntityId> entityIds)
+		{
+			destroyedEntityCount += entityIds.size();
+		});
+
+		std::vector<ECS::EntityId> entityIds;
+		registry.createMany(50'000, entityIds);
+		MANI_TEST_ASSERT(entityIds.size() == 50'000 && registry.size() == 50'001, "Should have created 50'000 entities");
+		MANI_TEST_ASSERT(createdEventCount == 1 && createdEntityCount == 50'000, "Should broadcast a single event for the whole batch");
+
+		registry.add<DataComponent>(entityIds[0])->someData = 42;
+		registry.emplaceMany<DataComponent, OtherDataComponent>(entityIds);
+		MANI_TEST_ASSERT(addedEventCount == 2, "Should broadcast one event per component type");
+		MANI_TEST_ASSERT(registry.get<DataComponent>(entityIds[0])->someData == 42, "Existing components should be left untouched");
+
+		size_t count = 0;
+		ECS::View<DataComponent, OtherDataComponent>(registry).each([&count](ECS::EntityId entityId, DataComponent& data, OtherDataComponent& otherData)
+		{
+			count += otherData.someOtherData == 10 ? 1 : 0;
+		});
+		MANI_TEST_ASSERT(count == 50'000, "Every entity should have both components");
+
+		const size_t destroyedCount = registry.destroyMany(std::span<const ECS::EntityId>(entityIds).first(25'000));
+		MANI_TEST_ASSERT(destroyedCount == 25'000 && destroyedEntityCount == 25'000, "Should destroy the first half");
+		MANI_TEST_ASSERT(registry.destroyMany(std::span<const ECS::EntityId>(entityIds).first(25'000)) == 0, "Destroyed entities should not be destroyed twice");
+		MANI_TEST_ASSERT(registry.size() == 25'001, "The second half should be alive");
+
+		// recycled entities are handed out first.
+		std::vector<ECS::EntityId> recycledEntityIds;
+		registry.createMany(10, recycledEntityIds);
+		MANI_TEST_ASSERT(registry.size() == 25'011 && !registry.has<DataComponent>(recycledEntityIds[0]), "Recycled entities should not have components");
+	}
+
+	struct SparseAssetComponent
+	{
+		static constexpr ECS::EComponentStorage storage = ECS::EComponentStorage::SparseSet;
+		std::shared_ptr<int> asset;
+	};
+
+	MANI_TEST(ComponentLifecycle, "Removing components, destroying entities and destroying the registry should run the components' destructors")
+	{
+		struct AssetComponent
+		{
+			std::shared_ptr<int> asset;
+		};
+
+		std::shared_ptr<int> asset = std::make_shared<int>(42);
+		{
+			ECS::Registry registry;
+			std::vector<ECS::EntityId> entityIds;
+			for (int i = 0; i < 10; ++i)
+			{
+				const ECS::EntityId entityId = registry.create();
+				registry.add<AssetComponent>(entityId)->asset = asset;
+				registry.add<SparseAssetComponent>(entityId)->asset = asset;
+				entityIds.push_back(entityId);
+			}
+			MANI_TEST_ASSERT(asset.use_count() == 21, "Every component should hold the asset");
+
+			registry.remove<AssetComponent>(entityIds[0]);
+			registry.remove<SparseAssetComponent>(entityIds[0]);
+			MANI_TEST_ASSERT(asset.use_count() == 19, "Removed components should release the asset");
+
+			registry.destroy(entityIds[1]);
+			registry.destroy(entityIds[2]);
+			MANI_TEST_ASSERT(asset.use_count() == 15, "Destroyed entities should release the asset");
+
+			// the sparse set moved its last component in the freed slots, they must still hold the asset.
+			for (size_t i = 3; i < entityIds.size(); ++i)
+			{
+				MANI_TEST_ASSERT(registry.get<SparseAssetComponent>(entityIds[i])->asset == asset, "Moved components should keep the asset");
+			}
+
+			// recycled entities start with fresh components.
+			const ECS::EntityId recycledEntityId = registry.create();
+			MANI_TEST_ASSERT(registry.add<AssetComponent>(recycledEntityId)->asset == nullptr, "A recycled slot should hold a new component");
+		}
+		MANI_TEST_ASSERT(asset.use_count() == 1, "Destroying the registry should release the asset");
+	}
+
+	MANI_TEST(TagComponents, "Empty components should be stored as bits only and still be usable in views")
+	{
+		struct SelectedTag {};
+		struct DataComponent
+		{
+			int someData = 5;
+		};
+
+		ECS::Registry registry;
+		std::vector<ECS::EntityId> entityIds;
+		registry.createMany(100, entityIds);
+		for (size_t i = 0; i < entityIds.size(); ++i)
+		{
+			registry.add<DataComponent>(entityIds[i]);
+			if (i % 4 == 0)
+			{
+				MANI_TEST_ASSERT(registry.add<SelectedTag>(entityIds[i]), "Adding a tag should succeed");
+			}
+		}
+		MANI_TEST_ASSERT(!registry.add<SelectedTag>(entityIds[0]), "Adding a tag twice should fail");
+		MANI_TEST_ASSERT(!registry.add<SelectedTag>(ECS::INVALID_ID), "Adding a tag to an invalid entity should fail");
+
+		size_t count = 0;
+		ECS::View<DataComponent, SelectedTag>(registry).each([&registry, &count](ECS::EntityId entityId, DataComponent& data, SelectedTag& tag)
+		{
+			MANI_TEST_ASSERT(registry.has<SelectedTag>(entityId), "Only tagged entities should be visited");
+			count++;
+		});
+		MANI_TEST_ASSERT(count == 25, "Every tagged entity should be visited");
+
+		count = 0;
+		ECS::View<DataComponent, ECS::Exclude<SelectedTag>>(registry).each([&count](ECS::EntityId entityId, DataComponent& data)
+		{
+			count++;
+		});
+		MANI_TEST_ASSERT(count == 75, "Tags should be excludable");
+
+		registry.remove<SelectedTag>(entityIds[0]);
+		MANI_TEST_ASSERT(!registry.has<SelectedTag>(entityIds[0]), "Removing a tag should clear it");
+
+		size_t addedCount = 0;
+		registry.onComponentsAdded.subscribe([&addedCount](ECS::Registry& registry, std::span<const ECS::EntityId> entityIds, ECS::ComponentId componentId)
+		{
+			addedCount += entityIds.size();
+		});
+		registry.emplaceMany<SelectedTag>(entityIds);
+		MANI_TEST_ASSERT(addedCount == 76, "emplaceMany should only report the entities the tag was added to");
+
+		ECS::CommandBuffer commandBuffer;
+		const ECS::EntityId pendingEntityId = commandBuffer.create();
+		commandBuffer.add<SelectedTag>(pendingEntityId);
+		commandBuffer.flush(registry);
+
+		count = 0;
+		ECS::View<SelectedTag>(registry).each([&count](ECS::EntityId entityId, SelectedTag& tag)
+		{
+			count++;
+		});
+		MANI_TEST_ASSERT(count == 101, "Command buffers should add tags");
+
+		// tags have no change versions, stamping one should not allocate any.
+		ECS::TagComponentPool pool(ECS::getComponentInfo<SelectedTag>());
+		const ECS::EntityId farEntityId = ECS::makeEntityId(1000000, 0);
+		pool.add(farEntityId);
+		pool.markAdded(ECS::getEntityIndex(farEntityId), 3);
+		MANI_TEST_ASSERT(pool.getVersionCount() == 0, "Tag pools should not store change versions");
+	}
+
+	struct SparseSnapshotComponent
+	{
+		static constexpr ECS::EComponentStorage storage = ECS::EComponentStorage::SparseSet;
+		float value = 0.0f;
+	};
+
+	MANI_TEST(SnapshotRestore, "A snapshot should restore the entities, their ids and their trivially copyable components")
+	{
+		struct DataComponent
+		{
 			int someData = 5;
 		};
-
-		struct OtherDataComponent {
-			int someOtherData = 10;
+		struct SnapshotTag {};
+		struct AssetComponent
+		{
+			std::shared_ptr<int> asset;
 		};
 
-		// create a registry
 		ECS::Registry registry;
-
-		// create e few entities, all of them with DataComponent, some of them with OtherDataComponent
-		const int entityCount = 10;
-		for (int i = 1; i < entityCount; i++)
+		std::vector<ECS::EntityId> entityIds;
+		registry.createMany(10, entityIds);
+		for (size_t i = 0; i < entityIds.size(); ++i)
 		{
-			const ECS::EntityId entityId = registry.create();
-			registry.add<DataComponent>(entityId);
+			registry.add<DataComponent>(entityIds[i])->someData = static_cast<int>(i);
 			if (i % 2 == 0)
 			{
-				registry.add<OtherDataComponent>(entityId);
+				registry.add<SparseSnapshotComponent>(entityIds[i])->value = static_cast<float>(i) * 0.5f;
+			}
+			if (i % 3 == 0)
+			{
+				registry.add<SnapshotTag>(entityIds[i]);
 			}
+			registry.add<AssetComponent>(entityIds[i])->asset = std::make_shared<int>(1);
 		}
 
-		MANI_TEST_ASSERT(registry.size() == entityCount, "should have created 10 entities");
+		// recycle an index so the snapshot holds a newer generation.
+		registry.destroy(entityIds[9]);
+		const ECS::EntityId staleEntityId = entityIds[9];
+		entityIds[9] = registry.create();
+		registry.add<DataComponent>(entityIds[9])->someData = 9;
+		registry.destroy(entityIds[8]);
 
-		int entityCounter = 1;
-		for (ECS::EntityId entityId : ECS::View<DataComponent, OtherDataComponent>(registry))
-		{
-			entityCounter++;
+		std::stringstream stream;
+		registry.snapshot(stream);
+		const std::string snapshot = stream.str();
 
-			auto* component = registry.get<DataComponent>(entityId);
-			MANI_TEST_ASSERT(component != nullptr, "should have a DataComponent");
+		ECS::Registry restoredRegistry;
+		ECS::Query<DataComponent> query(restoredRegistry);
+		MANI_TEST_ASSERT(query.size() == 0, "The query should start empty");
 
-			auto* otherComponent = registry.get<OtherDataComponent>(entityId);
-			MANI_TEST_ASSERT(otherComponent != nullptr, "should have a OtherDataComponent");
-		}
-		MANI_TEST_ASSERT(entityCounter == entityCount / 2, "There should be 5 entities with DataComponent and OtherDataComponent in the registry view");
+		MANI_TEST_ASSERT(restoredRegistry.restore(stream), "The snapshot should be restored");
+		MANI_TEST_ASSERT(restoredRegistry.size() == registry.size(), "Every alive entity should be restored");
+		MANI_TEST_ASSERT(!restoredRegistry.isValid(staleEntityId), "Stale ids should stay invalid");
+		MANI_TEST_ASSERT(!restoredRegistry.isValid(entityIds[8]), "Destroyed entities should stay destroyed");
+		MANI_TEST_ASSERT(query.size() == 9, "Queries should be refilled");
 
-		// iterate over the entities with DataComponent
-		entityCounter = 1;
-		for (ECS::EntityId entityId : ECS::View<DataComponent>(registry))
+		for (size_t i = 0; i < entityIds.size(); ++i)
 		{
-			entityCounter++;
-			auto* component = registry.get<DataComponent>(entityId);
-			MANI_TEST_ASSERT(component != nullptr, "should have a DataComponent");
+			if (i == 8)
+			{
+				continue;
+			}
+
+			const ECS::EntityId entityId = entityIds[i];
+			MANI_TEST_ASSERT(restoredRegistry.isValid(entityId), "Ids should be kept");
+			MANI_TEST_ASSERT(restoredRegistry.get<DataComponent>(entityId)->someData == static_cast<int>(i), "Indexed components should be restored");
+			MANI_TEST_ASSERT(!restoredRegistry.has<AssetComponent>(entityId), "Components that are not trivially copyable should not be saved");
+			if (i < 9)
+			{
+				MANI_TEST_ASSERT(restoredRegistry.has<SparseSnapshotComponent>(entityId) == (i % 2 == 0), "Sparse set components should be restored");
+				MANI_TEST_ASSERT(restoredRegistry.has<SnapshotTag>(entityId) == (i % 3 == 0), "Tags should be restored");
+			}
+			if (i % 2 == 0 && i < 9)
+			{
+				MANI_TEST_ASSERT(restoredRegistry.get<SparseSnapshotComponent>(entityId)->value == static_cast<float>(i) * 0.5f, "Sparse set values should be restored");
+			}
 		}
-		MANI_TEST_ASSERT(entityCounter == entityCount, "There should be 10 entities with DataComponent in the registry view");
 
-		entityCounter = 1;
-		for (ECS::EntityId entityId : ECS::View<OtherDataComponent>(registry))
+		size_t count = 0;
+		ECS::View<DataComponent, SnapshotTag>(restoredRegistry).each([&count](ECS::EntityId entityId, DataComponent& data, SnapshotTag& tag)
 		{
-			entityCounter++;
-			auto* otherComponent = registry.get<OtherDataComponent>(entityId);
-			MANI_TEST_ASSERT(otherComponent != nullptr, "should have a OtherDataComponent");
-		}
-		MANI_TEST_ASSERT(entityCounter == entityCount / 2, "There should be 5 entities with OtherDataComponent in the registry view");
+			count++;
+		});
+		MANI_TEST_ASSERT(count == 3, "Views should visit the restored archetypes");
 
+		// the recycled index is reused by the next entity created.
+		const ECS::EntityId createdEntityId = restoredRegistry.create();
+		MANI_TEST_ASSERT(ECS::getEntityIndex(createdEntityId) == ECS::getEntityIndex(entityIds[8]), "The free list should be restored");
 
-		entityCounter = 0;
-		for (ECS::EntityId entityId : ECS::View<>(registry))
+		std::stringstream truncatedStream(snapshot.substr(0, snapshot.size() / 2));
+		MANI_TEST_ASSERT(!restoredRegistry.restore(truncatedStream), "A truncated snapshot should be rejected");
+		MANI_TEST_ASSERT(restoredRegistry.isValid(createdEntityId) && query.size() == 9, "A rejected snapshot should leave the registry untouched");
+	}
+
+	MANI_TEST(CorruptSparseSetSnapshot, "A sparse set pool should reject component counts and entity indices its snapshot cannot hold")
+	{
+		const size_t entityCount = 64;
+		const SparseSnapshotComponent component;
+
+		// writes an occupancy of a single entity followed by componentCount entries for entityIndex.
+		auto writePool = [&component](std::ostream& stream, uint64_t componentCount, uint64_t entityIndex)
 		{
-			entityCounter++;
+			ECS::writeSnapshotValue(stream, static_cast<uint64_t>(1));
+			ECS::writeSnapshotValue(stream, static_cast<uint64_t>(1));
+			ECS::writeSnapshotValue(stream, componentCount);
+			for (uint64_t i = 0; i < std::min<uint64_t>(componentCount, 4); ++i)
+			{
+				ECS::writeSnapshotValue(stream, static_cast<uint64_t>(ECS::makeEntityId(static_cast<ECS::EntityId>(entityIndex), 0)));
+			}
+			ECS::writeSnapshotBytes(stream, &component, sizeof(component));
+		};
+
+		{
+			std::stringstream stream;
+			writePool(stream, 1, 0);
+			ECS::SparseSetComponentPool pool(ECS::getComponentInfo<SparseSnapshotComponent>());
+			MANI_TEST_ASSERT(pool.readSnapshot(stream, entityCount) && pool.size() == 1, "A valid pool should be read");
+		}
+		{
+			std::stringstream stream;
+			writePool(stream, UINT64_MAX, 0);
+			ECS::SparseSetComponentPool pool(ECS::getComponentInfo<SparseSnapshotComponent>());
+			MANI_TEST_ASSERT(!pool.readSnapshot(stream, entityCount), "A component count larger than the occupancy should be rejected");
+		}
+		{
+			std::stringstream stream;
+			writePool(stream, 1, ECS::ENTITY_INDEX_MASK - 1);
+			ECS::SparseSetComponentPool pool(ECS::getComponentInfo<SparseSnapshotComponent>());
+			MANI_TEST_ASSERT(!pool.readSnapshot(stream, entityCount), "An entity index past the snapshot's entities should be rejected");
+		}
+		{
+			std::stringstream stream;
+			ECS::writeSnapshotValue(stream, UINT64_MAX);
+			ECS::SparseSetComponentPool pool(ECS::getComponentInfo<SparseSnapshotComponent>());
+			MANI_TEST_ASSERT(!pool.readSnapshot(stream, entityCount), "An occupancy larger than the snapshot's entities should be rejected");
 		}
-		MANI_TEST_ASSERT(entityCounter == 10, "Should iterate over all entities");
 	}
 
-	MANI_TEST(ChaoticEntityCreation, "We should be able to create entities, some without component, and some with components")
+	MANI_TEST(Compaction, "compact should renumber the alive entities densely and remap their components")
 	{
-		struct DataComponent {
+		struct DataComponent
+		{
 			int someData = 5;
 		};
+		struct CompactedTag {};
+		struct AssetComponent
+		{
+			std::shared_ptr<int> asset;
+		};
+		struct SingletonComponent
+		{
+			int value = 0;
+		};
 
-		// create a registry
+		std::shared_ptr<int> asset = std::make_shared<int>(42);
 		ECS::Registry registry;
+		registry.addSingle<SingletonComponent>()->value = 7;
+		ECS::Query<DataComponent> query(registry);
 
-		// create e few entities, all of them with DataComponent, some of them with OtherDataComponent
-		int entityCount = 10;
-		// entity ids start at 1 to leave room for the singleton entity
-		for (int i = 1; i < entityCount; i++)
+		std::vector<ECS::EntityId> entityIds;
+		registry.createMany(3000, entityIds);
+		for (size_t i = 0; i < entityIds.size(); ++i)
 		{
-			const ECS::EntityId entityId = registry.create();
+			registry.add<DataComponent>(entityIds[i])->someData = static_cast<int>(i);
+			registry.add<AssetComponent>(entityIds[i])->asset = asset;
 			if (i % 2 == 0)
 			{
-				registry.add<DataComponent>(entityId);
+				registry.add<SparseSnapshotComponent>(entityIds[i])->value = static_cast<float>(i);
+			}
+			if (i % 3 == 0)
+			{
+				registry.add<CompactedTag>(entityIds[i]);
 			}
 		}
 
-		MANI_TEST_ASSERT(registry.size() == entityCount, "should have created 10 entities");
+		// keep one entity out of ten, scattered over the indices.
+		std::vector<ECS::EntityId> destroyedEntityIds;
+		std::vector<std::pair<ECS::EntityId, int>> keptEntities;
+		for (size_t i = 0; i < entityIds.size(); ++i)
+		{
+			if (i % 10 == 3)
+			{
+				keptEntities.push_back({ entityIds[i], static_cast<int>(i) });
+			}
+			else
+			{
+				destroyedEntityIds.push_back(entityIds[i]);
+			}
+		}
+		registry.destroyMany(destroyedEntityIds);
+		MANI_TEST_ASSERT(registry.unadjustedSize() == 3001, "Destroyed entities should leave holes");
 
-		// iterate over the entities with DataComponent
-		int entityCounter = 1;
-		for (ECS::EntityId entityId : ECS::View<DataComponent>(registry))
+		size_t broadcastCount = 0;
+		registry.onEntitiesRemapped.subscribe([&broadcastCount](ECS::Registry& registry, std::span<const ECS::EntityRemap> entityRemaps)
 		{
-			entityCounter++;
-			auto* component = registry.get<DataComponent>(entityId);
-			MANI_TEST_ASSERT(component != nullptr, "should have a DataComponent");
+			broadcastCount += entityRemaps.size();
+		});
+
+		std::vector<ECS::EntityRemap> remaps;
+		registry.compact(remaps);
+		MANI_TEST_ASSERT(registry.size() == 301 && registry.unadjustedSize() == 301, "Entities should be dense after compaction");
+		MANI_TEST_ASSERT(broadcastCount == remaps.size() && !remaps.empty(), "Renumbered entities should be broadcast");
+		MANI_TEST_ASSERT(registry.getSingle<SingletonComponent>()->value == 7, "The singleton should follow its entity");
+		MANI_TEST_ASSERT(asset.use_count() == 301, "Components should be moved, not copied nor leaked");
+		MANI_TEST_ASSERT(query.size() == 300, "Queries should follow the renumbered entities");
+
+		for (const ECS::EntityRemap& remap : remaps)
+		{
+			MANI_TEST_ASSERT(!registry.isValid(remap.oldId) && registry.isValid(remap.newId), "Old ids should be invalid and new ids valid");
+			for (std::pair<ECS::EntityId, int>& keptEntity : keptEntities)
+			{
+				if (keptEntity.first == remap.oldId)
+				{
+					keptEntity.first = remap.newId;
+				}
+			}
 		}
-		MANI_TEST_ASSERT(entityCounter == entityCount / 2, "There should be 5 entities with DataComponent in the registry view");
-	}
 
-	MANI_TEST(ComponentIdAssignation, "ComponentIds should be consecutive")
-	{	
-		struct Component0 {};
-		struct Component1 {};
-		struct Component2 {};
+		for (const std::pair<ECS::EntityId, int>& keptEntity : keptEntities)
+		{
+			const ECS::EntityId entityId = keptEntity.first;
+			const int i = keptEntity.second;
+			MANI_TEST_ASSERT(registry.isValid(entityId), "Remapped ids should be valid");
+			MANI_TEST_ASSERT(registry.get<DataComponent>(entityId)->someData == i, "Indexed components should follow their entity");
+			MANI_TEST_ASSERT(registry.get<AssetComponent>(entityId)->asset == asset, "Moved components should keep their content");
+			MANI_TEST_ASSERT(registry.has<SparseSnapshotComponent>(entityId) == (i % 2 == 0), "Sparse set components should follow their entity");
+			if (i % 2 == 0)
+			{
+				MANI_TEST_ASSERT(registry.get<SparseSnapshotComponent>(entityId)->value == static_cast<float>(i), "Sparse set values should follow their entity");
+			}
+			MANI_TEST_ASSERT(registry.has<CompactedTag>(entityId) == (i % 3 == 0), "Tags should follow their entity");
+		}
 
-		ECS::Registry registry;
-		const ECS::ComponentId componentId0 = registry.getComponentId<Component0>();
-		const ECS::ComponentId componentId1 = registry.getComponentId<Component1>();
-		const ECS::ComponentId componentId2 = registry.getComponentId<Component2>();
-		
-		MANI_TEST_ASSERT(componentId1 - componentId0 == 1, "The second componentid should follow the first one");
-		MANI_TEST_ASSERT(componentId2 - componentId1 == 1, "The third componentid should follow the second one");
-	}
+		size_t count = 0;
+		ECS::View<DataComponent, CompactedTag>(registry).each([&count](ECS::EntityId entityId, DataComponent& data, CompactedTag& tag)
+		{
+			MANI_TEST_ASSERT(data.someData % 3 == 0, "Views should visit the renumbered entities");
+			count++;
+		});
+		MANI_TEST_ASSERT(count == 100, "Views should visit every tagged entity");
 
-	MANI_TEST(Spawn1000000Entities, "Should spawn 1'000'000 entities with a transform")
-	{
-		struct Transform
+		count = 0;
+		query.each([&count](ECS::EntityId entityId, DataComponent& data)
 		{
-			float position[3];
-			float rotation[3];
-			float scale[3];
-		};
+			count++;
+		});
+		MANI_TEST_ASSERT(count == 300, "Queries should visit every entity");
+
+		const ECS::EntityId createdEntityId = registry.create();
+		MANI_TEST_ASSERT(ECS::getEntityIndex(createdEntityId) == 301, "New entities should be appended after compaction");
+		registry.destroy(keptEntities[0].first);
+		MANI_TEST_ASSERT(registry.size() == 301, "The registry should keep working after compaction");
+
+		std::vector<ECS::EntityRemap> lastRemaps;
+		registry.compact(lastRemaps);
+		MANI_TEST_ASSERT(lastRemaps.size() == 1 && lastRemaps[0].oldId == createdEntityId, "Only the last entity should move in the single hole");
+		MANI_TEST_ASSERT(registry.unadjustedSize() == 301, "The hole should be filled");
+
+		// the dropped indices are created again, the ids of their previous lives must stay invalid.
+		std::vector<ECS::EntityId> recreatedEntityIds;
+		registry.createMany(entityIds.size(), recreatedEntityIds);
+		MANI_TEST_ASSERT(registry.unadjustedSize() == 301 + entityIds.size(), "Every dropped index should be created again");
+		for (const ECS::EntityId entityId : destroyedEntityIds)
+		{
+			MANI_TEST_ASSERT(!registry.isValid(entityId), "Destroyed ids should stay invalid after their index is created again");
+		}
+		remaps.insert(remaps.end(), lastRemaps.begin(), lastRemaps.end());
+		for (const ECS::EntityRemap& remap : remaps)
+		{
+			MANI_TEST_ASSERT(!registry.isValid(remap.oldId), "Renumbered ids should stay invalid after their index is created again");
+		}
+	}
 
+	MANI_TEST(Hierarchy, "Relationships should link parents and children, be walked without allocation and follow destroy and compaction")
+	{
 		ECS::Registry registry;
-		for (int i = 1; i < 1'000'000; ++i)
+		std::vector<ECS::EntityId> entityIds;
+		registry.createMany(7, entityIds);
+
+		//        0
+		//      /   \
+		//     1     2
+		//    / \     \
+		//   3   4     5
+		// children are linked as first child, they are added last to first.
+		MANI_TEST_ASSERT(ECS::setParent(registry, entityIds[2], entityIds[0]), "Should parent 2 to 0");
+		MANI_TEST_ASSERT(ECS::setParent(registry, entityIds[1], entityIds[0]), "Should parent 1 to 0");
+		MANI_TEST_ASSERT(ECS::setParent(registry, entityIds[4], entityIds[1]), "Should parent 4 to 1");
+		MANI_TEST_ASSERT(ECS::setParent(registry, entityIds[3], entityIds[1]), "Should parent 3 to 1");
+		MANI_TEST_ASSERT(ECS::setParent(registry, entityIds[5], entityIds[2]), "Should parent 5 to 2");
+
+		MANI_TEST_ASSERT(!ECS::setParent(registry, entityIds[0], entityIds[3]), "Cycles should be rejected");
+		MANI_TEST_ASSERT(!ECS::setParent(registry, entityIds[0], entityIds[0]), "An entity should not be its own parent");
+		MANI_TEST_ASSERT(ECS::getParent(registry, entityIds[3]) == entityIds[1], "3's parent should be 1");
+		MANI_TEST_ASSERT(ECS::isDescendantOf(registry, entityIds[5], entityIds[0]), "5 should descend from 0");
+		MANI_TEST_ASSERT(registry.get<ECS::Relationship>(entityIds[0])->childCount == 2, "0 should have two children");
+
+		std::vector<ECS::EntityId> visitedEntityIds;
+		ECS::eachDescendant(registry, entityIds[0], [&visitedEntityIds](ECS::EntityId entityId)
 		{
-			const ECS::EntityId entityId = registry.create();
-			Transform* transform = registry.add<Transform>(entityId);
-			transform->position[0] = 1.f;
-			transform->position[1] = 1.f;
-			transform->position[2] = 1.f;
+			visitedEntityIds.push_back(entityId);
+		});
+		const std::vector<ECS::EntityId> depthFirstOrder{ entityIds[1], entityIds[3], entityIds[4], entityIds[2], entityIds[5] };
+		MANI_TEST_ASSERT(visitedEntityIds == depthFirstOrder, "Depth first walks should visit an entity before its children");
 
-			transform->rotation[0] = 1.f;
-			transform->rotation[1] = 1.f;
-			transform->rotation[2] = 1.f;
+		visitedEntityIds.clear();
+		ECS::eachDescendant(registry, entityIds[1], [&visitedEntityIds](ECS::EntityId entityId)
+		{
+			visitedEntityIds.push_back(entityId);
+		});
+		MANI_TEST_ASSERT(visitedEntityIds.size() == 2, "Walks should not leave the subtree");
 
-			transform->scale[0] = 1.f;
-			transform->scale[1] = 1.f;
-			transform->scale[2] = 1.f;
+		std::vector<ECS::EntityId> queue;
+		visitedEntityIds.clear();
+		ECS::eachDescendantBreadthFirst(registry, entityIds[0], queue, [&visitedEntityIds](ECS::EntityId entityId)
+		{
+			visitedEntityIds.push_back(entityId);
+		});
+		const std::vector<ECS::EntityId> breadthFirstOrder{ entityIds[1], entityIds[2], entityIds[3], entityIds[4], entityIds[5] };
+		MANI_TEST_ASSERT(visitedEntityIds == breadthFirstOrder, "Breadth first walks should visit the entities depth by depth");
+
+		// reparent 2 under 4.
+		MANI_TEST_ASSERT(ECS::setParent(registry, entityIds[2], entityIds[4]), "Should reparent 2 to 4");
+		MANI_TEST_ASSERT(registry.get<ECS::Relationship>(entityIds[0])->childCount == 1, "0 should have one child left");
+		MANI_TEST_ASSERT(ECS::isDescendantOf(registry, entityIds[5], entityIds[4]), "5 should follow its parent");
+
+		// destroying an entity orphans its children.
+		registry.destroy(entityIds[4]);
+		MANI_TEST_ASSERT(ECS::getParent(registry, entityIds[2]) == ECS::INVALID_ID, "Children of a destroyed entity should become roots");
+		MANI_TEST_ASSERT(registry.get<ECS::Relationship>(entityIds[1])->firstChild == entityIds[3], "The destroyed entity should leave its parent");
+		MANI_TEST_ASSERT(registry.get<ECS::Relationship>(entityIds[1])->childCount == 1, "The parent should have one child left");
+
+		// compaction renumbers the entities, links should follow.
+		ECS::setParent(registry, entityIds[2], entityIds[3]);
+		ECS::setParent(registry, entityIds[6], entityIds[2]);
+		std::vector<ECS::EntityRemap> remaps;
+		registry.compact(remaps);
+		MANI_TEST_ASSERT(!remaps.empty(), "The last entity should fill the hole");
+		for (const ECS::EntityRemap& remap : remaps)
+		{
+			std::replace(entityIds.begin(), entityIds.end(), remap.oldId, remap.newId);
 		}
+		MANI_TEST_ASSERT(ECS::getParent(registry, entityIds[6]) == entityIds[2], "Parent links should be remapped");
+		MANI_TEST_ASSERT(registry.get<ECS::Relationship>(entityIds[2])->firstChild == entityIds[6], "Child links should be remapped");
 
-		MANI_TEST_ASSERT(registry.size() == 1'000'000, "Should have spawned 1'000'000 entities.");
+		const size_t size = registry.size();
+		MANI_TEST_ASSERT(ECS::destroyRecursive(registry, entityIds[1]) == 5, "The subtree should be destroyed");
+		MANI_TEST_ASSERT(registry.size() == size - 5 && !registry.isValid(entityIds[6]), "Descendants should be destroyed");
+		MANI_TEST_ASSERT(registry.get<ECS::Relationship>(entityIds[0])->firstChild == ECS::INVALID_ID, "The root should have no child left");
 	}
 
-	MANI_TEST(PlayWithDynamicAllocation, "Should allow dynamic allocation")
+	MANI_TEST(StableComponentPointers, "Component pointers should stay valid while the pool grows")
 	{
-		struct DynamicComponent
+		struct DataComponent
 		{
-			std::vector<float> vector = { 1.f, 2.f, 3.f };
+			int someData = 5;
 		};
 
 		ECS::Registry registry;
-		const ECS::EntityId entity1 = registry.create();
-		const ECS::EntityId entity2 = registry.create();
 
-		DynamicComponent* component1 = registry.add<DynamicComponent>(entity1);
-		DynamicComponent* component2 = registry.add<DynamicComponent>(entity2);
-		for (int i = 0; i < 1000; ++i)
+		const ECS::EntityId entityId = registry.create();
+		DataComponent* component = registry.add<DataComponent>(entityId);
+		component->someData = 42;
+
+		for (int i = 0; i < 100'000; ++i)
 		{
-			component1->vector.push_back(i + 1 * 1000.f);
+			registry.add<DataComponent>(registry.create());
 		}
 
-		MANI_TEST_ASSERT(component2->vector[0] - 1.f <= 1.192092896e-07F, "first vector element should be equal to the original value");
-		MANI_TEST_ASSERT(component2->vector[1] - 2.f <= 1.192092896e-07F, "second vector element should be equal to the original value");
-		MANI_TEST_ASSERT(component2->vector[2] - 3.f <= 1.192092896e-07F, "third vector element should be equal to the original value");
+		MANI_TEST_ASSERT(registry.get<DataComponent>(entityId) == component, "Growing the pool should not move components");
+		MANI_TEST_ASSERT(component->someData == 42, "Component data should be intact after the pool grew");
 	}
 
 	MANI_TEST(EntityHasComponent, "Should return true if the entity has the component or not")
@@ -427,6 +1821,68 @@ MANI_SECTION_BEGIN(ECS, "ECS")
 		resultBitset.set(64);
 
 		MANI_TEST_ASSERT(resultBitset == (bitset | otherBitset), "should be able to add bitsets");
+
+		// wide signatures span several 64 bits words.
+		Bitset<256> signature;
+		signature.set(0);
+		signature.set(63);
+		signature.set(64);
+		signature.set(200);
+		signature.set(255);
+		MANI_TEST_ASSERT(signature.test(63) && signature.test(64) && signature.test(200) && signature.test(255), "bits of every word should be set");
+		MANI_TEST_ASSERT(!signature.test(1) && !signature.test(65) && !signature.test(256), "other bits should not be set");
+
+		Bitset<256> mask;
+		mask.set(64);
+		mask.set(255);
+		MANI_TEST_ASSERT(signature.contains(mask), "the signature should contain the mask");
+		mask.set(130);
+		MANI_TEST_ASSERT(!signature.contains(mask), "the signature should not contain a bit it does not have");
+		MANI_TEST_ASSERT(signature.intersects(mask), "the signature and the mask share bits");
+
+		Bitset<256> excludedMask;
+		excludedMask.set(130);
+		excludedMask.set(131);
+		MANI_TEST_ASSERT(!signature.intersects(excludedMask), "the signature and the excluded mask share no bit");
+		signature.set(200, false);
+		MANI_TEST_ASSERT(!signature.test(200) && signature.test(255), "resetting a bit should leave the others untouched");
+	}
+
+	template<size_t N>
+	struct NumberedComponent
+	{
+		size_t value = N;
+	};
+
+	MANI_TEST(ManyComponentTypes, "An entity should hold more component types than a 32 bits word")
+	{
+		ECS::Registry registry;
+		const ECS::EntityId entityId = registry.create();
+		const ECS::EntityId otherEntityId = registry.create();
+
+		auto addComponents = [&registry]<size_t ...TIndices>(ECS::EntityId entityId, std::index_sequence<TIndices...>)
+		{
+			(registry.add<NumberedComponent<TIndices>>(entityId), ...);
+			return (registry.has<NumberedComponent<TIndices>>(entityId) && ...) && ((registry.get<NumberedComponent<TIndices>>(entityId)->value == TIndices) && ...);
+		};
+		MANI_TEST_ASSERT(addComponents(entityId, std::make_index_sequence<40>()), "The entity should have all its components");
+		MANI_TEST_ASSERT(addComponents(otherEntityId, std::make_index_sequence<39>()), "The other entity should have all its components");
+
+		size_t count = 0;
+		ECS::View<NumberedComponent<0>, NumberedComponent<39>>(registry).each([&count, entityId](ECS::EntityId viewEntityId, NumberedComponent<0>& first, NumberedComponent<39>& last)
+		{
+			MANI_TEST_ASSERT(viewEntityId == entityId && last.value == 39, "Only the entity with the last component should be visited");
+			count++;
+		});
+		MANI_TEST_ASSERT(count == 1, "The view should match the components of every word");
+
+		count = 0;
+		ECS::View<NumberedComponent<38>, ECS::Exclude<NumberedComponent<39>>>(registry).each([&count, otherEntityId](ECS::EntityId viewEntityId, NumberedComponent<38>& component)
+		{
+			MANI_TEST_ASSERT(viewEntityId == otherEntityId, "The entity with the excluded component should be skipped");
+			count++;
+		});
+		MANI_TEST_ASSERT(count == 1, "Excluded components should be tested in every word");
 	}
 	
 	MANI_TEST(DoNotAssumeRegistrySizeContainsAllIndices, "Should iterate over all the entities")
@@ -476,8 +1932,7 @@ MANI_SECTION_BEGIN(ECS, "ECS")
 		ECS::View<Component> view(registry);
 		for (const ECS::EntityId entityId : view)
 		{
-			Component* comp = registry.get<Component>(entityId);
-			MANI_TEST_ASSERT(comp != nullptr && registry.isValid(entityId), "Entity should be valid");
+			MANI_TEST_ASSERT(registry.has<Component>(entityId) && registry.isValid(entityId), "Entity should be valid");
 
 			const ECS::EntityId newId = registry.create();
 			registry.add<CommonComponent>(newId);
@@ -485,6 +1940,114 @@ MANI_SECTION_BEGIN(ECS, "ECS")
 		}
 	}
 	
+	MANI_TEST(ArchetypeViewIteration, "Should only visit matching archetypes and allow editing the current entity during iteration")
+	{
+		struct Component {};
+		struct OtherComponent {};
+
+		ECS::Registry registry;
+
+		const size_t entityCount = 3000;
+		for (size_t i = 0; i < entityCount; ++i)
+		{
+			const ECS::EntityId entityId = registry.create();
+			registry.add<Component>(entityId);
+			if (i % 3 == 0)
+			{
+				registry.add<OtherComponent>(entityId);
+			}
+		}
+
+		size_t count = 0;
+		for (const ECS::EntityId entityId : ECS::View<Component, OtherComponent>(registry))
+		{
+			MANI_TEST_ASSERT(registry.has<OtherComponent>(entityId), "Should only visit entities with OtherComponent");
+			count++;
+		}
+		MANI_TEST_ASSERT(count == entityCount / 3, "Should visit all the entities with Component and OtherComponent");
+
+		// moving the current entity to another archetype should not skip any entity.
+		std::vector<ECS::EntityId> visited;
+		for (const ECS::EntityId entityId : ECS::View<Component>(registry))
+		{
+			visited.push_back(entityId);
+			registry.remove<Component>(entityId);
+		}
+		std::sort(visited.begin(), visited.end());
+		MANI_TEST_ASSERT(visited.size() == entityCount, "Should visit every entity with Component once");
+		MANI_TEST_ASSERT(std::unique(visited.begin(), visited.end()) == visited.end(), "Should not visit an entity twice");
+
+		count = 0;
+		for (const ECS::EntityId entityId : ECS::View<Component>(registry))
+		{
+			count++;
+		}
+		MANI_TEST_ASSERT(count == 0, "No entity should have a Component anymore");
+	}
+
+	MANI_SECTION_BEGIN(SparseSet, "tests on sparse set components")
+	{
+		struct SparseComponent
+		{
+			static constexpr ECS::EComponentStorage storage = ECS::EComponentStorage::SparseSet;
+			std::vector<int> values;
+		};
+
+		MANI_TEST(SparseSetComponents, "Should store sparse set components densely and keep them intact when others are removed")
+		{
+			struct DataComponent {};
+
+			ECS::Registry registry;
+
+			std::vector<ECS::EntityId> entityIds;
+			for (int i = 0; i < 100; ++i)
+			{
+				const ECS::EntityId entityId = registry.create();
+				registry.add<DataComponent>(entityId);
+				if (i % 10 == 0)
+				{
+					SparseComponent* component = registry.add<SparseComponent>(entityId);
+					component->values = { i, i + 1, i + 2 };
+					entityIds.push_back(entityId);
+				}
+			}
+
+			// removing from the middle of the pool moves the last component in the freed slot.
+			registry.remove<SparseComponent>(entityIds[2]);
+			registry.destroy(entityIds[5]);
+
+			for (size_t i = 0; i < entityIds.size(); ++i)
+			{
+				const SparseComponent* component = registry.get<SparseComponent>(entityIds[i]);
+				if (i == 2 || i == 5)
+				{
+					MANI_TEST_ASSERT(component == nullptr, "Removed components should not be retrieved");
+					continue;
+				}
+
+				const int expected = static_cast<int>(i) * 10;
+				MANI_TEST_ASSERT(component != nullptr && component->values.size() == 3 && component->values[0] == expected, "Components should survive other components' removal");
+			}
+
+			// the view is driven by the sparse set pool, which is smaller than the DataComponent archetypes.
+			size_t count = 0;
+			for (const ECS::EntityId entityId : ECS::View<DataComponent, SparseComponent>(registry))
+			{
+				MANI_TEST_ASSERT(registry.has<SparseComponent>(entityId) && registry.has<DataComponent>(entityId), "Should only visit entities with both components");
+				count++;
+			}
+			MANI_TEST_ASSERT(count == entityIds.size() - 2, "Should visit all the entities with a SparseComponent");
+
+			std::atomic<size_t> parallelCount = 0;
+			ECS::View<DataComponent, SparseComponent>(registry).parallelEach([&parallelCount](ECS::EntityId entityId, DataComponent& data, SparseComponent& component)
+			{
+				parallelCount++;
+			}, 2);
+			MANI_TEST_ASSERT(parallelCount == entityIds.size() - 2, "parallelEach should visit all the entities with a SparseComponent");
+		}
+	}
+	MANI_SECTION_END(SparseSet)
+
 	MANI_SECTION_BEGIN(TemplatedComponents, "tests on templated components")
 	{
 		template<typename T>
@@ -23,4 +23,20 @@ group "_TestLibs"
         links { "ECS" }
         
         includedirs { moduledir .. "/**" }
+group ""
+
+group "_Benchmarks"
+    project "ECSBenchmarks"
+        kind "ConsoleApp"
+        location (moduledir .. "/ECS/Benchmarks")
+
+        files { moduledir .. "/ECS/Benchmarks/**.h", moduledir .. "/ECS/Benchmarks/**.cpp" }
+
+        links { "ECS" }
+
+        includedirs { moduledir .. "/**" }
+
+        filter "system:linux"
+            links { "pthread" }
+        filter {}
 group ""
\ No newline at end of file
@@ -10,12 +10,10 @@ using namespace Mani;
 void InputSystem::tick(float deltaTime, ECS::Registry& registry)
 {
 	ECS::View<InputUser> inputUserView(registry);
-	for (const ECS::EntityId entityId : inputUserView)
+	inputUserView.each([this, &registry](ECS::EntityId entityId, InputUser& inputUser)
 	{
-		InputUser* inputUser = registry.get<InputUser>(entityId);
-		
 		// axis are reset each tick.
-		for (auto& [name, action] : inputUser->actions)
+		for (auto& [name, action] : inputUser.actions)
 		{
 			action.x = 0.f;
 			action.y = 0.f;
@@ -23,7 +21,7 @@ void InputSystem::tick(float deltaTime, ECS::Registry& registry)
 		}
 
 		// consume assigned input device
-		for (const ECS::EntityId deviceId : inputUser->inputDevices)
+		for (const ECS::EntityId deviceId : inputUser.inputDevices)
 		{
 			InputDevice* inputDevice = registry.get<InputDevice>(deviceId);
 			if (inputDevice == nullptr)
@@ -34,15 +32,15 @@ void InputSystem::tick(float deltaTime, ECS::Registry& registry)
 			// buttons
 			for (const ButtonControl& control : inputDevice->buttonBuffer)
 			{
-				auto boundActionNamesIt = inputUser->bindings.find(control.name);
-				if (boundActionNamesIt == inputUser->bindings.end())
+				auto boundActionNamesIt = inputUser.bindings.find(control.name);
+				if (boundActionNamesIt == inputUser.bindings.end())
 				{
 					continue;
 				}
 
 				for (const std::string& actionName : boundActionNamesIt->second)
 				{
-					InputAction& action = inputUser->actions[actionName];
+					InputAction& action = inputUser.actions[actionName];
 					if (action.isPressed != control.isPressed)
 					{
 						MANI_LOG_VERBOSE(LogInputs, "Action {} state changed to {}", action.name, action.isPressed);
@@ -55,15 +53,15 @@ void InputSystem::tick(float deltaTime, ECS::Registry& registry)
 			// axis
 			for (const AxisControl& axis : inputDevice->axis)
 			{
-				auto boundActionNamesIt = inputUser->bindings.find(axis.name);
-				if (boundActionNamesIt == inputUser->bindings.end())
+				auto boundActionNamesIt = inputUser.bindings.find(axis.name);
+				if (boundActionNamesIt == inputUser.bindings.end())
 				{
 					continue;
 				}
 
 				for (const std::string& actionName : boundActionNamesIt->second)
 				{
-					InputAction& action = inputUser->actions[actionName];
+					InputAction& action = inputUser.actions[actionName];
 
 					action.x += axis.x;
 					action.y += axis.y;
@@ -73,19 +71,18 @@ void InputSystem::tick(float deltaTime, ECS::Registry& registry)
 		}
 
 #if MANI_DEBUG
-		for (auto& [name, action] : inputUser->actions)
+		for (auto& [name, action] : inputUser.actions)
 		{
 			// log action state
 			MANI_LOG_VERBOSE(LogInputs, "Action {} axis changed to ({}, {}, {})", action.name, action.x, action.y, action.z);
 		}
 #endif
-	}
+	});
 
 	// clear button buffers
 	ECS::View<InputDevice> inputDeviceView(registry);
-	for (const ECS::EntityId entityId : inputDeviceView)
+	inputDeviceView.each([](ECS::EntityId entityId, InputDevice& inputDevice)
 	{
-		InputDevice* inputDevice = registry.get<InputDevice>(entityId);
-		inputDevice->buttonBuffer.clear();
-	}
+		inputDevice.buttonBuffer.clear();
+	});
 }
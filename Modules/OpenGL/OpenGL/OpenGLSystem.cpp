@@ -15,10 +15,6 @@
 #include <vector>
 #include <memory>
 
-#ifdef __EMSCRIPTEN__
-#include <emscripten.h>
-#endif
-
 using namespace Mani;
 
 OpenGLSystem* OpenGLSystem::s_openGLSystem = nullptr;
@@ -159,8 +155,4 @@ void OpenGLSystem::tick(float deltaTime, ECS::Registry& entityRegistry)
 {
     glfwSwapBuffers(m_context.window);
     glfwPollEvents();
-
-#ifdef __EMSCRIPTEN__
-    emscripten_sleep(100);
-#endif
 }
\ No newline at end of file
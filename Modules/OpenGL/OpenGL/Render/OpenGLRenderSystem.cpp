@@ -5,7 +5,7 @@
 #include <Core/Components/Transform.h>
 
 #include <ECS/Registry.h>
-#include <ECS/View.h>
+#include <ECS/Query.h>
 
 #include <Camera/CameraSystem.h>
 
@@ -48,6 +48,13 @@ void OpenGLRenderSystem::onInitialize(ECS::Registry& registry, SystemContainer&
 {
 	m_resourceSystem = systemContainer.initializeDependency<OpenGLResourceSystem>();
 	m_cameraSystem = systemContainer.initializeDependency<CameraSystem>();
+
+	m_camerasQuery = ECS::Query<CameraComponent>(registry);
+	m_directionalLightsQuery = ECS::Query<DirectionalLightComponent>(registry);
+	m_pointLightsQuery = ECS::Query<Transform, PointLightComponent>(registry);
+	m_spotlightsQuery = ECS::Query<Transform, SpotlightComponent>(registry);
+	m_meshesQuery = ECS::Query<Transform, MeshComponent>(registry);
+	m_spritesQuery = ECS::Query<Transform, SpriteComponent>(registry);
 }
 
 void OpenGLRenderSystem::tick(float deltaTime, ECS::Registry& registry)
@@ -59,13 +66,11 @@ void OpenGLRenderSystem::tick(float deltaTime, ECS::Registry& registry)
 
 	uint32_t x, y, width, height;
 	getViewport(x, y, width, height);
-	ECS::View<CameraComponent> cameraView(registry);
-	for (const auto& entityId : cameraView)
+	m_camerasQuery.each([width, height](ECS::EntityId entityId, CameraComponent& cameraComponent)
 	{
-		CameraComponent* cameraComponent = registry.get<CameraComponent>(entityId);
-		cameraComponent->config.width = static_cast<float>(width);
-		cameraComponent->config.height = static_cast<float>(height);
-	}
+		cameraComponent.config.width = static_cast<float>(width);
+		cameraComponent.config.height = static_cast<float>(height);
+	});
 
 	std::shared_ptr<OpenGLResourceSystem> resourceSystem = m_resourceSystem.lock();
 	
@@ -100,44 +105,36 @@ void OpenGLRenderSystem::tick(float deltaTime, ECS::Registry& registry)
 	// consuming color state.
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	ECS::View<DirectionalLightComponent> directionalLightsView(registry);
-	ECS::View<Transform, PointLightComponent> pointLightsView(registry);
-	ECS::View<Transform, SpotlightComponent> spotlightsView(registry);
-
 	// Render MeshComponents
-	ECS::View<Transform, MeshComponent> meshesView(registry);
-	for (const ECS::EntityId entityId : meshesView)
+	m_meshesQuery.each([this, &resourceSystem, &viewMatrix, &projectionMatrix, &cameraPosition](ECS::EntityId entityId, const Transform& transform, const MeshComponent& meshComponent)
 	{
-		Transform* transform = registry.get<Transform>(entityId);
-		const MeshComponent* meshComponent = registry.get<MeshComponent>(entityId);
-
-		if (meshComponent->mesh == nullptr)
+		if (meshComponent.mesh == nullptr)
 		{
 			MANI_LOG_WARNING(LogOpenGL, "Entity {} with null mesh or material", entityId);
-			continue;
+			return;
 		}
 
-		const std::shared_ptr<Mesh>& mesh = meshComponent->mesh;
-		const std::shared_ptr<Material>& materialAsset = meshComponent->material;
+		const std::shared_ptr<Mesh>& mesh = meshComponent.mesh;
+		const std::shared_ptr<Material>& materialAsset = meshComponent.material;
 
 		if (mesh == nullptr || materialAsset == nullptr)
 		{
 			MANI_LOG_WARNING(LogOpenGL, "Entity {} with null mesh or material", entityId);
-			continue;
+			return;
 		}
 
 		const std::shared_ptr<OpenGLVertexArray>& vao = resourceSystem->getVertexArray(mesh->name);
 		if (vao == nullptr)
 		{
 			MANI_LOG_WARNING(LogOpenGL, "Attempting to draw a mesh that is not loaded");
-			continue;
+			return;
 		}
 
 		const std::shared_ptr<OpenGLMaterial> material = resourceSystem->getMaterial(materialAsset->name);
 		if (material == nullptr)
 		{
 			MANI_LOG_WARNING(LogOpenGL, "Attempting to draw a material that is not loaded");
-			continue;
+			return;
 		}
 
 		MANI_ASSERT(!material->shader.empty(), "A Shader is always expected in a material");
@@ -146,12 +143,12 @@ void OpenGLRenderSystem::tick(float deltaTime, ECS::Registry& registry)
 		if (shader == nullptr)
 		{
 			MANI_LOG_WARNING(LogOpenGL, "Attempting to draw a mesh with an uncompiled shader");
-			continue;
+			return;
 		}
 
 		shader->use();
 
-		glm::mat4 modelMatrix = transform->calculateModelMatrix();
+		glm::mat4 modelMatrix = transform.calculateModelMatrix();
 		glm::mat3 normalMatrix = glm::inverseTranspose(glm::mat3(modelMatrix));
 
 		// set vertex uniforms
@@ -194,55 +191,48 @@ void OpenGLRenderSystem::tick(float deltaTime, ECS::Registry& registry)
 		int directionalLightIndex = 0;
 		int pointLightIndex = 0;
 		int spotlightIndex = 0;
-		for(const ECS::EntityId entityId : directionalLightsView)
+		m_directionalLightsQuery.each([&shader, &directionalLightIndex](ECS::EntityId entityId, const DirectionalLightComponent& light)
 		{
-			const DirectionalLightComponent* light = registry.get<DirectionalLightComponent>(entityId);
-
 			const std::string directionalLightArray = std::format("directionalLights[{}]", directionalLightIndex);
-			shader->setFloat3(std::format("{}.direction", directionalLightArray).c_str(), light->direction.x, light->direction.y, light->direction.z);
-			shader->setFloat3(std::format("{}.ambient", directionalLightArray).c_str(), light->ambient.x, light->ambient.y, light->ambient.z);
-			shader->setFloat3(std::format("{}.diffuse", directionalLightArray).c_str(), light->diffuse.x, light->diffuse.y, light->diffuse.z);
-			shader->setFloat3(std::format("{}.specular", directionalLightArray).c_str(), light->specular.x, light->specular.x, light->specular.x);
+			shader->setFloat3(std::format("{}.direction", directionalLightArray).c_str(), light.direction.x, light.direction.y, light.direction.z);
+			shader->setFloat3(std::format("{}.ambient", directionalLightArray).c_str(), light.ambient.x, light.ambient.y, light.ambient.z);
+			shader->setFloat3(std::format("{}.diffuse", directionalLightArray).c_str(), light.diffuse.x, light.diffuse.y, light.diffuse.z);
+			shader->setFloat3(std::format("{}.specular", directionalLightArray).c_str(), light.specular.x, light.specular.x, light.specular.x);
 			directionalLightIndex++;
-		}
+		});
 
-		for (const ECS::EntityId entityId : pointLightsView)
+		m_pointLightsQuery.each([&shader, &pointLightIndex](ECS::EntityId entityId, const Transform& transform, const PointLightComponent& light)
 		{
-			const Transform* transform = registry.get<Transform>(entityId);
-			const PointLightComponent* light = registry.get<PointLightComponent>(entityId);
-
 			const std::string pointLightArray = std::format("pointLights[{}]", pointLightIndex);
-			shader->setFloat3(std::format("{}.position", pointLightArray).c_str(), transform->position.x, transform->position.y, transform->position.z);
+			shader->setFloat3(std::format("{}.position", pointLightArray).c_str(), transform.position.x, transform.position.y, transform.position.z);
 
-			shader->setFloat3(std::format("{}.ambient", pointLightArray).c_str(), light->ambient.x, light->ambient.y, light->ambient.z);
-			shader->setFloat3(std::format("{}.diffuse", pointLightArray).c_str(), light->diffuse.x, light->diffuse.y, light->diffuse.z);
-			shader->setFloat3(std::format("{}.specular", pointLightArray).c_str(), light->specular.x, light->specular.x, light->specular.x);
+			shader->setFloat3(std::format("{}.ambient", pointLightArray).c_str(), light.ambient.x, light.ambient.y, light.ambient.z);
+			shader->setFloat3(std::format("{}.diffuse", pointLightArray).c_str(), light.diffuse.x, light.diffuse.y, light.diffuse.z);
+			shader->setFloat3(std::format("{}.specular", pointLightArray).c_str(), light.specular.x, light.specular.x, light.specular.x);
 
-			shader->setFloat(std::format("{}.constant", pointLightArray).c_str(), light->constant);
-			shader->setFloat(std::format("{}.linear", pointLightArray).c_str(), light->linear);
-			shader->setFloat(std::format("{}.quadratic", pointLightArray).c_str(), light->quadratic);
+			shader->setFloat(std::format("{}.constant", pointLightArray).c_str(), light.constant);
+			shader->setFloat(std::format("{}.linear", pointLightArray).c_str(), light.linear);
+			shader->setFloat(std::format("{}.quadratic", pointLightArray).c_str(), light.quadratic);
 
 			pointLightIndex++;
-		}
+		});
 
-		for (const ECS::EntityId entityId : spotlightsView)
+		m_spotlightsQuery.each([&shader, &spotlightIndex](ECS::EntityId entityId, const Transform& transform, const SpotlightComponent& light)
 		{
-			const Transform* transform = registry.get<Transform>(entityId);
-			const SpotlightComponent* light = registry.get<SpotlightComponent>(entityId);
-			const glm::vec3 forward = transform->forward();
+			const glm::vec3 forward = transform.forward();
 
 			const std::string spotlightsArray = std::format("spotlights[{}]", spotlightIndex);
-			shader->setFloat3(std::format("{}.position", spotlightsArray).c_str(), transform->position.x, transform->position.y, transform->position.z);
+			shader->setFloat3(std::format("{}.position", spotlightsArray).c_str(), transform.position.x, transform.position.y, transform.position.z);
 			shader->setFloat3(std::format("{}.direction", spotlightsArray).c_str(), forward.x, forward.y, forward.z);
-			shader->setFloat(std::format("{}.cutOff", spotlightsArray).c_str(), light->cutOff);
-			shader->setFloat(std::format("{}.outterCutOff", spotlightsArray).c_str(), light->outterCutOff);
+			shader->setFloat(std::format("{}.cutOff", spotlightsArray).c_str(), light.cutOff);
+			shader->setFloat(std::format("{}.outterCutOff", spotlightsArray).c_str(), light.outterCutOff);
 
-			shader->setFloat3(std::format("{}.ambient", spotlightsArray).c_str(), light->ambient.x, light->ambient.y, light->ambient.z);
-			shader->setFloat3(std::format("{}.diffuse", spotlightsArray).c_str(), light->diffuse.x, light->diffuse.y, light->diffuse.z);
-			shader->setFloat3(std::format("{}.specular", spotlightsArray).c_str(), light->specular.x, light->specular.x, light->specular.x);
+			shader->setFloat3(std::format("{}.ambient", spotlightsArray).c_str(), light.ambient.x, light.ambient.y, light.ambient.z);
+			shader->setFloat3(std::format("{}.diffuse", spotlightsArray).c_str(), light.diffuse.x, light.diffuse.y, light.diffuse.z);
+			shader->setFloat3(std::format("{}.specular", spotlightsArray).c_str(), light.specular.x, light.specular.x, light.specular.x);
 
 			spotlightIndex++;
-		}
+		});
 
 		shader->setInt("directionalLightsCount", directionalLightIndex);
 		shader->setInt("pointLightsCount", pointLightIndex);
@@ -270,22 +260,18 @@ void OpenGLRenderSystem::tick(float deltaTime, ECS::Registry& registry)
 		{
 			specularTexture->unbind();
 		}
-	}
+	});
 
 	// Render SpriteComponents
-	ECS::View<Transform, SpriteComponent> spritesView(registry);
-	for (const ECS::EntityId entityId : spritesView)
+	m_spritesQuery.each([&resourceSystem, &viewMatrix, &projectionMatrix](ECS::EntityId entityId, const Transform& transform, const SpriteComponent& spriteComponent)
 	{
-		const Transform* transform = registry.get<Transform>(entityId);
-		const SpriteComponent* spriteComponent = registry.get<SpriteComponent>(entityId);
-
-		if (spriteComponent->sprite == nullptr)
+		if (spriteComponent.sprite == nullptr)
 		{
 			MANI_LOG_WARNING(LogOpenGL, "Entity {} with null sprite", entityId);
 			return;
 		}
 
-		const std::shared_ptr<OpenGLSprite> sprite = resourceSystem->getSprite(spriteComponent->sprite->name);
+		const std::shared_ptr<OpenGLSprite> sprite = resourceSystem->getSprite(spriteComponent.sprite->name);
 		if (sprite == nullptr)
 		{
 			MANI_LOG_WARNING(LogOpenGL, "Attempting to draw a sprite that is not loaded");
@@ -301,7 +287,7 @@ void OpenGLRenderSystem::tick(float deltaTime, ECS::Registry& registry)
 			return;
 		}
 
-		const std::shared_ptr<OpenGLVertexArray> vao = resourceSystem->getQuad(spriteComponent->repeatAmount);
+		const std::shared_ptr<OpenGLVertexArray> vao = resourceSystem->getQuad(spriteComponent.repeatAmount);
 		if (vao == nullptr)
 		{
 			MANI_LOG_WARNING(LogOpenGL, "Attempting to draw a vao that is not loaded");
@@ -315,13 +301,13 @@ void OpenGLRenderSystem::tick(float deltaTime, ECS::Registry& registry)
 			return;
 		}
 
-		texture->setFilteringMode(spriteComponent->filteringMode);
+		texture->setFilteringMode(spriteComponent.filteringMode);
 
 		shader->use();
 
 		//Transform scaledTransform = *transform;
-		Transform transformCopy = *transform;
-		const glm::vec2& pivot = spriteComponent->pivot;
+		Transform transformCopy = transform;
+		const glm::vec2& pivot = spriteComponent.pivot;
 		
 		// since we know the quad is 1x1, we can assume that the scale is the actual world size.
 		transformCopy.position.x += pivot.x * transformCopy.scale.x;
@@ -348,7 +334,7 @@ void OpenGLRenderSystem::tick(float deltaTime, ECS::Registry& registry)
 		int textureIndex = 0;
 		texture->bind(textureIndex);
 		shader->setTextureSlot("sprite", textureIndex++);
-		shader->setFloat4("color", spriteComponent->color.x, spriteComponent->color.y, spriteComponent->color.z, spriteComponent->color.w);
+		shader->setFloat4("color", spriteComponent.color.x, spriteComponent.color.y, spriteComponent.color.z, spriteComponent.color.w);
 
 		vao->bind();
 		if (const auto& indexBuffer = vao->getIndexBuffer())
@@ -361,7 +347,7 @@ void OpenGLRenderSystem::tick(float deltaTime, ECS::Registry& registry)
 		}
 
 		texture->unbind();
-	}
+	});
 }
 
 void Mani::OpenGLRenderSystem::getViewport(uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height)
@@ -2,6 +2,14 @@
 
 #include <Core/System/System.h>
 #include <RenderAPI/IRenderSystem.h>
+#include <RenderAPI/MeshComponent.h>
+#include <RenderAPI/SpriteComponent.h>
+#include <RenderAPI/Light/DirectionalLightComponent.h>
+#include <RenderAPI/Light/PointLightComponent.h>
+#include <RenderAPI/Light/SpotlightComponent.h>
+#include <Core/Components/Transform.h>
+#include <Camera/CameraSystem.h>
+#include <ECS/Query.h>
 #include <map>
 #include <memory>
 
@@ -32,6 +40,14 @@ namespace Mani
 		std::weak_ptr<CameraSystem> m_cameraSystem;
 
 		glm::vec4 m_clearColor = glm::vec4(.1f, .1f, .1f, 1.f);
+
+		// built once, the registry keeps them up to date.
+		ECS::Query<CameraComponent> m_camerasQuery;
+		ECS::Query<DirectionalLightComponent> m_directionalLightsQuery;
+		ECS::Query<Transform, PointLightComponent> m_pointLightsQuery;
+		ECS::Query<Transform, SpotlightComponent> m_spotlightsQuery;
+		ECS::Query<Transform, MeshComponent> m_meshesQuery;
+		ECS::Query<Transform, SpriteComponent> m_spritesQuery;
 	};
 }
 
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <ECS/ComponentPool.h>
 #include <glm/glm.hpp>
 
 namespace Mani
 {
 	struct DirectionalLightComponent
 	{
+		// lights are rare, keep them packed.
+		static constexpr ECS::EComponentStorage storage = ECS::EComponentStorage::SparseSet;
+
 		glm::vec3 direction = glm::vec3(-0.2f, -1.0f, -0.3f);
 
 		glm::vec3 ambient = glm::vec3(0.2f);
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <ECS/ComponentPool.h>
 #include <glm/glm.hpp>
 
 namespace Mani
 {
 	struct PointLightComponent
 	{
+        // lights are rare, keep them packed.
+        static constexpr ECS::EComponentStorage storage = ECS::EComponentStorage::SparseSet;
+
         glm::vec3 ambient = glm::vec3(0.2f);
         glm::vec3 diffuse = glm::vec3(0.5f);
         glm::vec3 specular = glm::vec3(1.0f);
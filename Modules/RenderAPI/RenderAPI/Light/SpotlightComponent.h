@@ -1,11 +1,15 @@
 #pragma once
 
+#include <ECS/ComponentPool.h>
 #include <glm/glm.hpp>
 
 namespace Mani
 {
 	struct SpotlightComponent
 	{
+        // lights are rare, keep them packed.
+        static constexpr ECS::EComponentStorage storage = ECS::EComponentStorage::SparseSet;
+
         float cutOff = glm::cos(glm::radians(12.5f));
         float outterCutOff = glm::cos(glm::radians(17.5f));
 
@@ -2,8 +2,10 @@
 
 #include <RenderAPI/MeshComponent.h>
 #include <Assets/AssetSystem.h>
+#include <ECS/Hierarchy.h>
 
 #include <unordered_map>
+#include <vector>
 
 #include <ManiZ/ManiZ.h>
 #include <Core/GLMSerialization.h>
@@ -39,30 +41,38 @@ ECS::EntityId SceneSystem::spawnScene(ECS::Registry& registry, const std::filesy
 		return ECS::INVALID_ID;
 	}
 
-	const ECS::EntityId rootNodeEntityId = spawnNode(registry, Scene::Node(), assetSystem, materialAssetPath);
-
-	for (const auto& node : scene->nodes)
+	// the root and all the nodes are created and given a transform in bulk.
+	std::vector<ECS::EntityId> entityIds;
+	registry.createMany(scene->nodes.size() + 1, entityIds);
+	if (entityIds.size() != scene->nodes.size() + 1)
 	{
+		registry.destroyMany(entityIds);
+		return ECS::INVALID_ID;
+	}
+	registry.emplaceMany<Transform>(entityIds);
+
+	const ECS::EntityId rootNodeEntityId = entityIds[0];
+	spawnNode(registry, rootNodeEntityId, Scene::Node(), assetSystem, materialAssetPath);
 
-		const ECS::EntityId nodeEntityId = spawnNode(registry, node, assetSystem, materialAssetPath);
+	for (size_t i = 0; i < scene->nodes.size(); ++i)
+	{
+		const ECS::EntityId nodeEntityId = entityIds[i + 1];
+		spawnNode(registry, nodeEntityId, scene->nodes[i], assetSystem, materialAssetPath);
 		
-		Transform* nodeTransform = registry.get<Transform>(nodeEntityId);
-		nodeTransform->parentId = rootNodeEntityId;
+		ECS::setParent(registry, nodeEntityId, rootNodeEntityId);
 	}
 
 	return rootNodeEntityId;
 }
 
-ECS::EntityId SceneSystem::spawnNode(ECS::Registry& registry, const Scene::Node& node, const std::shared_ptr<AssetSystem>& assetSystem, const std::filesystem::path& materialAssetPath)
+bool SceneSystem::spawnNode(ECS::Registry& registry, ECS::EntityId entityId, const Scene::Node& node, const std::shared_ptr<AssetSystem>& assetSystem, const std::filesystem::path& materialAssetPath)
 {
 	if (assetSystem == nullptr)
 	{
-		return ECS::INVALID_ID;
+		return false;
 	}
 
-	ECS::EntityId entityId = registry.create();
-
-	Transform* transform = registry.add<Transform>(entityId);
+	Transform* transform = registry.get<Transform>(entityId);
 	transform->localPosition = node.localPosition;
 	transform->localRotation = node.localRotation;
 	transform->localScale = node.localScale;
@@ -72,13 +82,13 @@ ECS::EntityId SceneSystem::spawnNode(ECS::Registry& registry, const Scene::Node&
 		std::shared_ptr<Mesh> mesh = assetSystem->loadAsset<Mesh>(registry, node.meshAsset).lock();
 		if (mesh == nullptr)
 		{
-			return ECS::INVALID_ID;
+			return false;
 		}
 
 		std::shared_ptr<Material> material = assetSystem->loadAsset<Material>(registry, materialAssetPath).lock();
 		if (mesh == nullptr)
 		{
-			return ECS::INVALID_ID;
+			return false;
 		}
 
 		MeshComponent* meshComponent = registry.add<MeshComponent>(entityId);
@@ -86,5 +96,5 @@ ECS::EntityId SceneSystem::spawnNode(ECS::Registry& registry, const Scene::Node&
 		meshComponent->material = material;
 	}
 
-	return entityId;
+	return true;
 }
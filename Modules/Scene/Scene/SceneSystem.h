@@ -23,7 +23,9 @@ namespace Mani
 	private:
 		std::weak_ptr<AssetSystem> m_assetSystem;
 		
+		// sets up the transform and mesh of an entity created by spawnScene.
+		// returns false if the node's assets could not be loaded, the entity then only has its transform.
 		// todo #14: remove the material asset parameter.
-		ECS::EntityId spawnNode(ECS::Registry& registry, const Scene::Node& node, const std::shared_ptr<AssetSystem>& assetSystem, const std::filesystem::path& materialAssetPath);
+		bool spawnNode(ECS::Registry& registry, ECS::EntityId entityId, const Scene::Node& node, const std::shared_ptr<AssetSystem>& assetSystem, const std::filesystem::path& materialAssetPath);
 	};
 }
\ No newline at end of file
@@ -4,7 +4,7 @@ include "Engine/BuildScripts/buildwebgl.lua"
 workspace "Manifold"
 
 configurations { "Debug", "Release", "Distribution" }
-    platforms { "MacOSX", "WebGL", "Win64" }
+    platforms { "MacOSX", "WebGL", "Win64", "Linux" }
     startproject "Sandbox"
     language "C++"
     cppdialect "C++20"
@@ -41,6 +41,10 @@ configurations { "Debug", "Release", "Distribution" }
         architecture "x64"
         system "windows"
 
+    filter "platforms:Linux"
+        architecture "x64"
+        system "linux"
+
     filter "platforms:WebGL"
         defines { "MANI_WEBGL" }
         linkoptions { "-sUSE_GLFW=3", "-sMAX_WEBGL_VERSION=2" }
@@ -52,6 +56,9 @@ configurations { "Debug", "Release", "Distribution" }
     filter "system:windows"
         defines { "MANI_WINDOWS" }
 
+    filter "system:linux"
+        defines { "MANI_LINUX" }
+
 group "Engine"
     include "Engine"
 